@@ -0,0 +1,20 @@
+# Bake texture atlases at build time with the gf_atlas tool
+#
+# gf_bake_atlas(NAME DIRECTORY OUTPUT)
+# packs the PNG images of DIRECTORY and produces <OUTPUT>.png and
+# <OUTPUT>.atlas, NAME is the target that builds them
+
+function(gf_bake_atlas NAME DIRECTORY OUTPUT)
+  if(NOT TARGET gf_atlas)
+    message(FATAL_ERROR "gf_bake_atlas(${NAME}) needs the gf_atlas tool, enable GF_BUILD_TOOLS")
+  endif()
+
+  file(GLOB images "${DIRECTORY}/*.png")
+  add_custom_command(
+    OUTPUT "${OUTPUT}.png" "${OUTPUT}.atlas"
+    COMMAND gf_atlas "${DIRECTORY}" "${OUTPUT}"
+    DEPENDS gf_atlas ${images}
+    COMMENT "Baking atlas ${OUTPUT}"
+  )
+  add_custom_target(${NAME} ALL DEPENDS "${OUTPUT}.png" "${OUTPUT}.atlas")
+endfunction()
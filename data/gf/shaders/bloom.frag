@@ -0,0 +1,36 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#version 100
+
+precision mediump float;
+
+varying vec4 v_color;
+varying vec2 v_texCoords;
+
+uniform sampler2D u_texture;
+uniform sampler2D u_bloomTexture;
+uniform float u_intensity;
+
+void main(void) {
+  vec4 scene = texture2D(u_texture, v_texCoords);
+  vec4 bloom = texture2D(u_bloomTexture, v_texCoords);
+  gl_FragColor = vec4(scene.rgb + bloom.rgb * u_intensity, scene.a) * v_color;
+}
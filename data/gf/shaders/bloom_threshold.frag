@@ -0,0 +1,37 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#version 100
+
+precision mediump float;
+
+varying vec4 v_color;
+varying vec2 v_texCoords;
+
+uniform sampler2D u_texture;
+uniform float u_threshold;
+
+void main(void) {
+  vec4 color = texture2D(u_texture, v_texCoords);
+  float luma = dot(color.rgb, vec3(0.299, 0.587, 0.114));
+  // keep the part of the color above the threshold
+  float factor = max(luma - u_threshold, 0.0) / max(luma, 0.0001);
+  gl_FragColor = vec4(color.rgb * factor, 1.0) * v_color;
+}
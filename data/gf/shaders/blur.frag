@@ -0,0 +1,40 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#version 100
+
+precision mediump float;
+
+varying vec4 v_color;
+varying vec2 v_texCoords;
+varying vec2 v_blurTexCoords[4];
+
+uniform sampler2D u_texture;
+
+void main(void) {
+  // the coordinates are computed in the vertex shader, there is no
+  // dependent texture read
+  vec4 color = texture2D(u_texture, v_texCoords) * 0.2270270270;
+  color += texture2D(u_texture, v_blurTexCoords[0]) * 0.0702702703;
+  color += texture2D(u_texture, v_blurTexCoords[1]) * 0.3162162162;
+  color += texture2D(u_texture, v_blurTexCoords[2]) * 0.3162162162;
+  color += texture2D(u_texture, v_blurTexCoords[3]) * 0.0702702703;
+  gl_FragColor = color * v_color;
+}
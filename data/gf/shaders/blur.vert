@@ -0,0 +1,49 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#version 100
+
+attribute vec2 a_position;
+attribute vec4 a_color;
+attribute vec2 a_texCoords;
+
+varying vec4 v_color;
+varying vec2 v_texCoords;
+varying vec2 v_blurTexCoords[4];
+
+uniform mat3 u_transform;
+uniform vec2 u_step;
+
+void main(void) {
+  v_texCoords = a_texCoords;
+  v_color = a_color;
+
+  // 9-tap gaussian kernel with 5 bilinear fetches: each fetch between two
+  // texels gets both of them with the right weights
+  v_blurTexCoords[0] = a_texCoords - 3.2307692308 * u_step;
+  v_blurTexCoords[1] = a_texCoords - 1.3846153846 * u_step;
+  v_blurTexCoords[2] = a_texCoords + 1.3846153846 * u_step;
+  v_blurTexCoords[3] = a_texCoords + 3.2307692308 * u_step;
+
+  vec3 worldPosition = vec3(a_position, 1);
+  vec3 normalizedPosition = worldPosition * u_transform;
+
+  gl_Position = vec4(normalizedPosition.xy, 0, 1);
+}
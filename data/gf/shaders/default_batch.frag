@@ -0,0 +1,62 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#version 100
+
+precision mediump float;
+
+varying vec4 v_color;
+varying vec2 v_texCoords;
+varying float v_textureSlot;
+
+uniform sampler2D u_texture0;
+uniform sampler2D u_texture1;
+uniform sampler2D u_texture2;
+uniform sampler2D u_texture3;
+uniform sampler2D u_texture4;
+uniform sampler2D u_texture5;
+uniform sampler2D u_texture6;
+uniform sampler2D u_texture7;
+
+// GLSL ES 1.00 can not index an array of samplers with a varying
+vec4 sampleTexture(float slot, vec2 coords) {
+  if (slot < 0.5) {
+    return texture2D(u_texture0, coords);
+  } else if (slot < 1.5) {
+    return texture2D(u_texture1, coords);
+  } else if (slot < 2.5) {
+    return texture2D(u_texture2, coords);
+  } else if (slot < 3.5) {
+    return texture2D(u_texture3, coords);
+  } else if (slot < 4.5) {
+    return texture2D(u_texture4, coords);
+  } else if (slot < 5.5) {
+    return texture2D(u_texture5, coords);
+  } else if (slot < 6.5) {
+    return texture2D(u_texture6, coords);
+  }
+
+  return texture2D(u_texture7, coords);
+}
+
+void main(void) {
+  vec4 color = sampleTexture(v_textureSlot, v_texCoords);
+  gl_FragColor = color * v_color;
+}
@@ -117,6 +117,8 @@ int main() {
                 std::cout << "Stopping benchmark...\n";
                 std::cout << "\tFrame count: " << times.size() << '\n';
                 std::cout << "\tAverage time: " << std::accumulate(times.begin(), times.end(), std::chrono::duration<double, std::micro>(0)).count() / times.size() << " µs\n";
+                std::cout << "\tSprites per frame: " << carsCount << '\n';
+                std::cout << "\tSprites per ms: " << carsCount * times.size() * 1000.0 / std::accumulate(times.begin(), times.end(), std::chrono::duration<double, std::micro>(0)).count() << '\n';
                 times.clear();
               }
               break;
@@ -0,0 +1,120 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <cstdio>
+
+#include <chrono>
+#include <vector>
+
+#include <gf/Math.h>
+#include <gf/Random.h>
+#include <gf/Transform.h>
+
+static constexpr std::size_t PointCount = 1024 * 1024;
+static constexpr std::size_t QuadCount = PointCount / 4;
+static constexpr int Iterations = 20;
+
+template<typename Func>
+static void benchmark(const char *name, std::size_t count, Func func) {
+  func(); // warm up
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < Iterations; ++i) {
+    func();
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / Iterations / count;
+  std::printf("%-28s %8.3f ns/item\n", name, ns);
+}
+
+int main() {
+  gf::Random random;
+
+  std::vector<gf::Vector2f> points(PointCount);
+
+  for (auto& point : points) {
+    point = { random.computeUniformFloat(-1000.0f, 1000.0f), random.computeUniformFloat(-1000.0f, 1000.0f) };
+  }
+
+  gf::Matrix3f mat = gf::identity<gf::Matrix3f>();
+  gf::translate(mat, { 100.0f, 50.0f });
+  gf::rotate(mat, gf::Pi / 6);
+  gf::scale(mat, { 2.0f, 0.5f });
+
+  std::vector<gf::Vector2f> result(PointCount);
+
+  std::printf("%zu points, %d iterations\n", PointCount, Iterations);
+
+  benchmark("transform (scalar loop)", PointCount, [&]() {
+    for (std::size_t i = 0; i < PointCount; ++i) {
+      result[i] = gf::transform(mat, points[i]);
+    }
+  });
+
+  benchmark("transform (batch)", PointCount, [&]() {
+    gf::transform(mat, points.data(), result.data(), PointCount);
+  });
+
+  gf::RectF scalarBounds;
+  gf::RectF batchBounds;
+  volatile float zero = 0.0f; // prevents the compiler from hoisting the computations out of the loop
+
+  benchmark("bounds (scalar loop)", PointCount, [&]() {
+    points[0].x += zero;
+
+    gf::Vector2f min = points[0];
+    gf::Vector2f max = points[0];
+
+    for (auto& point : points) {
+      min = gf::min(min, point);
+      max = gf::max(max, point);
+    }
+
+    scalarBounds = gf::RectF(min, max - min);
+  });
+
+  benchmark("bounds (batch)", PointCount, [&]() {
+    points[0].x += zero;
+    batchBounds = gf::computeBounds(points.data(), PointCount);
+  });
+
+  std::vector<gf::Matrix3f> transforms(QuadCount, mat);
+  std::vector<gf::Vector2f> sizes(QuadCount, gf::Vector2f(32.0f, 64.0f));
+
+  benchmark("quads (scalar loop)", QuadCount, [&]() {
+    for (std::size_t i = 0; i < QuadCount; ++i) {
+      gf::Vector2f size = sizes[i];
+      result[4 * i + 0] = gf::transform(transforms[i], { 0.0f, 0.0f });
+      result[4 * i + 1] = gf::transform(transforms[i], gf::Vector2f(size.width, 0.0f));
+      result[4 * i + 2] = gf::transform(transforms[i], gf::Vector2f(0.0f, size.height));
+      result[4 * i + 3] = gf::transform(transforms[i], size);
+    }
+  });
+
+  benchmark("quads (batch)", QuadCount, [&]() {
+    gf::expandQuads(transforms.data(), sizes.data(), result.data(), sizeof(gf::Vector2f), QuadCount);
+  });
+
+  std::printf("bounds: %f %f %f %f\n", scalarBounds.left, scalarBounds.top, scalarBounds.width, scalarBounds.height);
+  std::printf("bounds: %f %f %f %f\n", batchBounds.left, batchBounds.top, batchBounds.width, batchBounds.height);
+  return 0;
+}
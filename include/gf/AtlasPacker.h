@@ -0,0 +1,230 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_ATLAS_PACKER_H
+#define GF_ATLAS_PACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Portability.h"
+#include "Rect.h"
+#include "Vector.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  class Image;
+  class Texture;
+  class TextureAtlas;
+
+  /**
+   * @ingroup game
+   * @brief A packer of rectangles in a bin
+   *
+   * The packer uses the MaxRects algorithm with the best short side fit
+   * heuristic: it maintains the list of the maximal free rectangles of the
+   * bin and puts each new rectangle in the free rectangle where it leaves
+   * the smallest leftover on one side.
+   *
+   * If rotation is allowed, a rectangle may be placed rotated by 90
+   * degrees. In this case, the width and the height of the returned
+   * rectangle are swapped.
+   *
+   * @sa gf::AtlasPacker
+   */
+  class GF_API RectanglePacker {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param size The size of the bin
+     * @param allowRotation True to allow the rotation of the rectangles
+     */
+    RectanglePacker(Vector2u size, bool allowRotation = false);
+
+    /**
+     * @brief Get the size of the bin
+     *
+     * @return The size of the bin
+     */
+    Vector2u getSize() const {
+      return m_size;
+    }
+
+    /**
+     * @brief Insert a rectangle in the bin
+     *
+     * @param size The size of the rectangle
+     * @param rect The place of the rectangle in the bin, if it fits
+     * @return True if the rectangle has been inserted
+     */
+    bool insert(Vector2u size, RectU& rect);
+
+    /**
+     * @brief Get the ratio of the bin that is used
+     *
+     * @return A ratio between 0 and 1
+     */
+    float getOccupancy() const;
+
+  private:
+    void splitFreeRectangles(const RectU& used);
+    void pruneFreeRectangles();
+
+  private:
+    Vector2u m_size;
+    bool m_allowRotation;
+    std::vector<RectU> m_freeRectangles;
+    uint64_t m_usedArea;
+  };
+
+  /**
+   * @ingroup game
+   * @brief A runtime packer of images in texture atlases
+   *
+   * An atlas packer puts many small images in a few big textures, called
+   * pages, so that the sprites using these images share the same texture
+   * and can be drawn in a single draw call (see gf::SpriteBatch).
+   *
+   * Each page has a texture and a gf::TextureAtlas that gives the
+   * rectangle of each image, with the name given in `addImage()`. When an
+   * image does not fit in the existing pages, a new page is added. The
+   * images are uploaded to the texture immediately, so a graphics context
+   * must be active.
+   *
+   * ~~~{.cc}
+   * gf::AtlasPacker packer;
+   * packer.addImage("hero", heroImage);
+   * packer.addImage("enemy", enemyImage);
+   *
+   * const gf::TextureAtlas *atlas = packer.findAtlas("hero");
+   *
+   * gf::Sprite sprite;
+   * sprite.setTexture(*atlas->getTexture());
+   * sprite.setTextureRect(atlas->getTextureRect("hero"));
+   * ~~~
+   *
+   * A padding is left between the images so that they do not bleed into
+   * each other with the smooth filter. The images are never rotated
+   * because a sprite can not draw a rotated sub-texture.
+   *
+   * @sa gf::TextureAtlas, gf::RectanglePacker, gf::ResourceManager
+   */
+  class GF_API AtlasPacker {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param pageSize The size of the textures of the pages
+     * @param padding The space between two images, in pixels
+     */
+    AtlasPacker(Vector2u pageSize = { 2048, 2048 }, unsigned padding = 1);
+
+    /**
+     * @brief Destructor
+     */
+    ~AtlasPacker();
+
+    /**
+     * @brief Deleted copy constructor
+     */
+    AtlasPacker(const AtlasPacker&) = delete;
+
+    /**
+     * @brief Deleted copy assignment
+     */
+    AtlasPacker& operator=(const AtlasPacker&) = delete;
+
+    /**
+     * @brief Add an image to the atlas
+     *
+     * The image is put in the first page where it fits. If the name is
+     * already in the atlas, the image is not added and the atlas of the
+     * existing image is returned.
+     *
+     * @param name The name of the image in the atlas
+     * @param image The image to add
+     * @return The atlas of the page of the image or `nullptr` if the image
+     * is bigger than a page
+     */
+    const TextureAtlas *addImage(const std::string& name, const Image& image);
+
+    /**
+     * @brief Find the atlas of an image
+     *
+     * @param name The name of the image in the atlas
+     * @return The atlas of the page of the image or `nullptr` if the name
+     * is unknown
+     */
+    const TextureAtlas *findAtlas(const std::string& name) const;
+
+    /**
+     * @brief Get the number of pages
+     *
+     * @return The number of pages
+     */
+    std::size_t getPageCount() const {
+      return m_pages.size();
+    }
+
+    /**
+     * @brief Get the texture of a page
+     *
+     * The texture can be modified, for example to enable the smooth
+     * filter, but not updated.
+     *
+     * @param page The index of the page
+     * @return The texture of the page
+     */
+    Texture& getTexture(std::size_t page);
+
+    /**
+     * @brief Get the atlas of a page
+     *
+     * @param page The index of the page
+     * @return The atlas of the page
+     */
+    const TextureAtlas& getAtlas(std::size_t page) const;
+
+  private:
+    struct Page;
+
+    Page& addPage();
+
+  private:
+    Vector2u m_pageSize;
+    unsigned m_padding;
+    std::vector<std::unique_ptr<Page>> m_pages;
+    std::map<std::string, std::size_t> m_names;
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_ATLAS_PACKER_H
@@ -0,0 +1,218 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_BLUR_EFFECTS_H
+#define GF_BLUR_EFFECTS_H
+
+#include "Effect.h"
+#include "Portability.h"
+#include "RenderPipeline.h"
+#include "RenderTargetPool.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  /**
+   * @ingroup graphics
+   * @brief Blur effect
+   *
+   * This multi-pass effect blurs the scene with a gaussian kernel. The
+   * scene is first downsampled to half or quarter resolution, then blurred
+   * with separable horizontal and vertical passes, and finally upsampled to
+   * the target. The blur passes use a 9-tap kernel computed with 5 texture
+   * fetches thanks to the bilinear filtering: a fetch between two texels
+   * gets both of them with the right weights.
+   *
+   * The kernel covers 9 texels of the downsampled texture, i.e. 18 pixels
+   * of the scene at half resolution and 36 pixels at quarter resolution.
+   * Each additional iteration widens the blur.
+   *
+   * The cost for a scene of @f$ P @f$ pixels, counted in shaded pixels,
+   * with @f$ n @f$ iterations is:
+   *
+   * Downsampling | Downsample    | Blur (per iteration)      | Upsample  | Total (n = 1)
+   * ------------ | ------------- | ------------------------- | --------- | -------------
+   * Half         | 0.25P         | 0.5P (2.5P fetches)       | P         | 1.75P
+   * Quarter      | 0.25P + 0.06P | 0.125P (0.625P fetches)   | P         | 1.44P
+   *
+   * For comparison, the same kernel at full resolution costs 2P shaded
+   * pixels and 10P fetches per iteration, and the straightforward 9-tap
+   * kernel 18P fetches. The upsample pass is a simple copy that is
+   * needed by any effect. The intermediate targets come from the pool of
+   * the pipeline and are released at the end of the effect.
+   *
+   * ~~~{.cc}
+   * gf::BlurEffect blur;
+   * blur.setDownsampling(gf::BlurEffect::Downsampling::Quarter);
+   * pipeline.addEffect(blur);
+   * ~~~
+   *
+   * @sa gf::RenderPipeline, gf::BloomEffect
+   */
+  class GF_API BlurEffect : public MultiPassEffect {
+  public:
+    /**
+     * @brief The resolution of the blur passes
+     */
+    enum class Downsampling : unsigned {
+      Half    = 2, ///< Half resolution (default)
+      Quarter = 4, ///< Quarter resolution
+    };
+
+    /**
+     * @brief Default constructor
+     */
+    BlurEffect();
+
+    /**
+     * @brief Set the resolution of the blur passes
+     *
+     * @param downsampling The new downsampling
+     *
+     * @sa getDownsampling()
+     */
+    void setDownsampling(Downsampling downsampling) {
+      m_downsampling = downsampling;
+    }
+
+    /**
+     * @brief Get the resolution of the blur passes
+     *
+     * @return The current downsampling
+     *
+     * @sa setDownsampling()
+     */
+    Downsampling getDownsampling() const {
+      return m_downsampling;
+    }
+
+    /**
+     * @brief Set the number of iterations of the blur
+     *
+     * An iteration is a horizontal pass and a vertical pass. The default
+     * is one iteration.
+     *
+     * @param iterations The new number of iterations
+     *
+     * @sa getIterations()
+     */
+    void setIterations(unsigned iterations) {
+      m_iterations = iterations;
+    }
+
+    /**
+     * @brief Get the number of iterations of the blur
+     *
+     * @return The current number of iterations
+     *
+     * @sa setIterations()
+     */
+    unsigned getIterations() const {
+      return m_iterations;
+    }
+
+    virtual void apply(RenderPipeline& pipeline, const Texture& source, const RenderTargetPool::Target *target) override;
+
+  protected:
+    /**
+     * @brief Blur a texture at low resolution
+     *
+     * The first downsample pass is made with the given effect, so that a
+     * subclass can filter the texture at the same time.
+     *
+     * @param pipeline The pipeline that runs the effect
+     * @param source The texture to blur
+     * @param filter The effect of the first downsample pass
+     * @return A target with the blurred texture, that must be released in
+     * the pool of the pipeline, or `nullptr` if the targets could not be
+     * acquired
+     */
+    RenderTargetPool::Target *blur(RenderPipeline& pipeline, const Texture& source, Effect& filter);
+
+    /**
+     * @brief Get an effect that copies the texture
+     *
+     * @return A copy effect
+     */
+    Effect& getCopyEffect() {
+      return m_copy;
+    }
+
+  private:
+    Downsampling m_downsampling;
+    unsigned m_iterations;
+    Effect m_copy;
+    Effect m_blur;
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief Bloom effect
+   *
+   * This multi-pass effect adds a glow around the bright parts of the
+   * scene. The parts above a luminance threshold are extracted during the
+   * downsample pass, blurred like in gf::BlurEffect and added to the scene.
+   *
+   * The cost is the cost of gf::BlurEffect, with two texture fetches per
+   * pixel in the final pass instead of one.
+   *
+   * @sa gf::RenderPipeline, gf::BlurEffect
+   */
+  class GF_API BloomEffect : public BlurEffect {
+  public:
+    /**
+     * @brief Default constructor
+     */
+    BloomEffect();
+
+    /**
+     * @brief Set the luminance threshold
+     *
+     * The parts of the scene with a luminance below the threshold do not
+     * glow. The default threshold is 0.7.
+     *
+     * @param threshold The new threshold, between 0 and 1
+     */
+    void setThreshold(float threshold);
+
+    /**
+     * @brief Set the intensity of the glow
+     *
+     * The default intensity is 1.
+     *
+     * @param intensity The new intensity
+     */
+    void setIntensity(float intensity);
+
+    virtual void apply(RenderPipeline& pipeline, const Texture& source, const RenderTargetPool::Target *target) override;
+
+  private:
+    Effect m_threshold;
+    Effect m_combine;
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_BLUR_EFFECTS_H
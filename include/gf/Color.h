@@ -154,6 +154,29 @@ inline namespace v1 {
      */
     static Color4f darker(Color4f color, float percent = 0.5f);
 
+    /**
+     * @brief Convert a color to 8-bit components
+     *
+     * The components are clamped in @f$ [0, 1] @f$ and rounded to the
+     * nearest 8-bit value.
+     *
+     * @param color The color with float components
+     * @return The color with 8-bit components
+     *
+     * @sa fromRgba32()
+     */
+    static Color4u toRgba32(Color4f color);
+
+    /**
+     * @brief Convert a color from 8-bit components
+     *
+     * @param color The color with 8-bit components
+     * @return The color with float components
+     *
+     * @sa toRgba32()
+     */
+    static Color4f fromRgba32(Color4u color);
+
   };
 
 
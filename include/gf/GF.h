@@ -27,7 +27,9 @@
 #include "Animation.h"
 #include "Array2D.h"
 #include "AssetManager.h"
+#include "AtlasPacker.h"
 #include "Blend.h"
+#include "BlurEffects.h"
 #include "BufferedGeometry.h"
 #include "Clock.h"
 #include "Color.h"
@@ -46,6 +48,8 @@
 #include "Filesystem.h"
 #include "Font.h"
 #include "Gamepad.h"
+#include "GpuTimer.h"
+#include "GraphicsDebug.h"
 #include "Id.h"
 #include "Image.h"
 #include "InputStream.h"
@@ -71,8 +75,10 @@
 #include "Range.h"
 #include "Rect.h"
 #include "RenderPipeline.h"
+#include "RenderQueue.h"
 #include "RenderStates.h"
 #include "RenderTarget.h"
+#include "RenderTargetPool.h"
 #include "RenderTexture.h"
 #include "RenderWindow.h"
 #include "ResourceManager.h"
@@ -0,0 +1,149 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_GPU_TIMER_H
+#define GF_GPU_TIMER_H
+
+#include <cstddef>
+
+#include "Portability.h"
+#include "Time.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  /**
+   * @ingroup graphics
+   * @brief A timer for the GPU
+   *
+   * A GPU timer measures the time spent by the GPU to execute the commands
+   * issued between `begin()` and `end()`, for example a pass of a render
+   * pipeline. It uses the `GL_EXT_disjoint_timer_query` extension. When the
+   * extension is not available, the timer does nothing and never has a
+   * result.
+   *
+   * The GPU executes the commands later than they are issued, so the
+   * result is not available immediately. The timer keeps a few queries in
+   * flight and `getElapsedTime()` returns the last available result,
+   * usually from a frame that was issued a few frames before. The timer
+   * never waits for the GPU.
+   *
+   * ~~~{.cc}
+   * gf::GpuTimer timer;
+   *
+   * // in the main loop
+   * timer.begin();
+   * renderer.draw(scene);
+   * timer.end();
+   *
+   * if (timer.hasResult()) {
+   *   float ms = timer.getElapsedTime().asSeconds() * 1000.0f;
+   * }
+   * ~~~
+   *
+   * Only one timer can be running at a time: timers can not be nested
+   * or overlapped.
+   *
+   * @sa gf::RenderTarget::getStats()
+   */
+  class GF_API GpuTimer {
+  public:
+    /**
+     * @brief Default constructor
+     */
+    GpuTimer();
+
+    /**
+     * @brief Destructor
+     */
+    ~GpuTimer();
+
+    /**
+     * @brief Deleted copy constructor
+     */
+    GpuTimer(const GpuTimer&) = delete;
+
+    /**
+     * @brief Deleted copy assignment
+     */
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /**
+     * @brief Check if GPU timers are available
+     *
+     * @return True if the timers are available on the current context
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief Start the measure
+     *
+     * If too many measures are still in flight, this measure is skipped.
+     *
+     * @sa end()
+     */
+    void begin();
+
+    /**
+     * @brief Stop the measure
+     *
+     * @sa begin()
+     */
+    void end();
+
+    /**
+     * @brief Check if a result is available
+     *
+     * @return True if at least one measure has completed
+     */
+    bool hasResult();
+
+    /**
+     * @brief Get the last measured time
+     *
+     * The measures that were disturbed by a disjoint event (for example,
+     * a change of the GPU frequency) are discarded.
+     *
+     * @return The GPU time of the last completed measure, or zero
+     */
+    Time getElapsedTime();
+
+  private:
+    void poll();
+
+  private:
+    static constexpr std::size_t QueryCount = 4;
+
+    unsigned m_queries[QueryCount];
+    std::size_t m_first;
+    std::size_t m_pending;
+    bool m_running;
+    bool m_hasResult;
+    Time m_elapsed;
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_GPU_TIMER_H
@@ -0,0 +1,135 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_GRAPHICS_DEBUG_H
+#define GF_GRAPHICS_DEBUG_H
+
+#include "Log.h"
+#include "Portability.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  /**
+   * @ingroup graphics
+   * @brief Reporting of the OpenGL errors
+   *
+   * The OpenGL errors can be reported in two ways:
+   *
+   * - with a callback (gf::GraphicsDebug::Mode::Callback), the driver
+   *   reports the errors and the warnings through the `GL_KHR_debug`
+   *   extension. The reporting is asynchronous and does not slow down the
+   *   rendering, so that a scene can be profiled with the validation on.
+   *   In a debug build (`GF_DEBUG`), the messages indicate the location of
+   *   the last OpenGL call issued by the library. This location is exact
+   *   only in synchronous mode (see `setSynchronous()`).
+   * - with a check after every call (gf::GraphicsDebug::Mode::Check), the
+   *   library calls `glGetError()` after every OpenGL call and reports the
+   *   exact location of the errors. This forces a synchronization between
+   *   the CPU and the GPU after every call and is very slow. This mode is
+   *   only available in a debug build.
+   *
+   * In a debug build, the default mode is the callback mode. If
+   * `GL_KHR_debug` is not available, nothing is reported in this mode. In
+   * a release build, the default mode is gf::GraphicsDebug::Mode::None, so
+   * that the context is not a debug context, which is slower on many
+   * drivers.
+   *
+   * The mode should be set before the creation of the window, so that the
+   * OpenGL context is created with the debug flag. It can be changed
+   * afterwards.
+   *
+   * ~~~{.cc}
+   * gf::GraphicsDebug::setMode(gf::GraphicsDebug::Mode::Callback);
+   * gf::GraphicsDebug::setMinimumSeverity(gf::Log::Info);
+   *
+   * gf::Window window("Game", { 640, 480 });
+   * ~~~
+   */
+  class GF_API GraphicsDebug {
+  public:
+    /**
+     * @brief Deleted constructor
+     */
+    GraphicsDebug() = delete;
+
+    /**
+     * @brief The reporting mode of the OpenGL errors
+     */
+    enum class Mode {
+      None,     ///< The errors are not reported
+      Callback, ///< The errors are reported by the driver with `GL_KHR_debug`
+      Check,    ///< The errors are checked after every call (slow, debug build only)
+    };
+
+    /**
+     * @brief Set the reporting mode
+     *
+     * @param mode The new mode
+     *
+     * @sa getMode()
+     */
+    static void setMode(Mode mode);
+
+    /**
+     * @brief Get the reporting mode
+     *
+     * @return The current mode
+     *
+     * @sa setMode()
+     */
+    static Mode getMode();
+
+    /**
+     * @brief Set the minimum severity of the messages of the callback
+     *
+     * The severities of the driver messages are mapped to the log levels:
+     * high to gf::Log::Error, medium to gf::Log::Warn, low to
+     * gf::Log::Info and notifications to gf::Log::Debug. The messages
+     * below the minimum severity are discarded by the driver.
+     *
+     * The default minimum severity is gf::Log::Warn.
+     *
+     * @param level The minimum severity
+     */
+    static void setMinimumSeverity(Log::Level level);
+
+    /**
+     * @brief Make the callback synchronous
+     *
+     * In synchronous mode, the driver calls the callback during the
+     * OpenGL call that generated the message, so that the location of
+     * the message is exact. This may slow down the driver.
+     *
+     * By default, the callback is asynchronous.
+     *
+     * @param synchronous True to make the callback synchronous
+     */
+    static void setSynchronous(bool synchronous);
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_GRAPHICS_DEBUG_H
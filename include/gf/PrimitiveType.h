@@ -38,6 +38,12 @@ inline namespace v1 {
    * [glDrawArrays](http://docs.gl/es2/glDrawArrays) or
    * [glDrawElements](http://docs.gl/es2/glDrawElements).
    *
+   * gf::PrimitiveType::Quads has no OpenGL equivalent. Quads are drawn as
+   * two triangles with a shared index buffer, so that each quad only needs
+   * four vertices instead of six. The vertices of a quad are given in this
+   * order: top-left, top-right, bottom-left, bottom-right (i.e. the same
+   * order as a triangle strip). Quads can not be used with indices.
+   *
    * @sa gf::RenderTarget::draw
    */
   enum class PrimitiveType {
@@ -48,6 +54,7 @@ inline namespace v1 {
     TriangleStrip,  ///< List of connected triangles, a point uses the two previous points to form a triangle
     TriangleFan,    ///< List of connected triangles, a point uses the common center and the previous point to form a triangle
     Triangles,      ///< List of individual triangles
+    Quads,          ///< List of individual quads, made of two triangles
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -23,9 +23,13 @@
 
 #include <vector>
 
+#include "Clock.h"
 #include "Effects.h"
 #include "Portability.h"
+#include "PostProcessing.h"
 #include "RenderTarget.h"
+#include "RenderTargetPool.h"
+#include "Time.h"
 
 namespace gf {
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -33,8 +37,37 @@ inline namespace v1 {
 #endif
 
   class Effect;
+  class RenderPipeline;
   class Window;
 
+  /**
+   * @ingroup graphics
+   * @brief An effect made of several passes
+   *
+   * A multi-pass effect draws its passes with RenderPipeline::drawPass().
+   * Its intermediate targets are acquired from the pool of the pipeline
+   * (see RenderPipeline::getTargetPool()) and must be released before the
+   * end of `apply()`, so that they are reused by the next frame.
+   *
+   * @sa gf::RenderPipeline, gf::BlurEffect, gf::BloomEffect
+   */
+  class GF_API MultiPassEffect {
+  public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~MultiPassEffect();
+
+    /**
+     * @brief Apply the effect
+     *
+     * @param pipeline The pipeline that runs the effect
+     * @param source The texture to process
+     * @param target The target of the last pass, `nullptr` for the window
+     */
+    virtual void apply(RenderPipeline& pipeline, const Texture& source, const RenderTargetPool::Target *target) = 0;
+  };
+
   /**
    * @ingroup graphics
    * @brief A render pipeline
@@ -64,7 +97,20 @@ inline namespace v1 {
    * };
    * ~~~
    *
-   * @sa gf::Effect
+   * The scene is drawn in an offscreen texture and each effect is applied
+   * in a full-screen pass. The last effect draws directly to the window.
+   * When there is no effect, the scene is drawn directly to the window.
+   * A gf::MultiPassEffect runs its own passes, with intermediate targets
+   * from the pool, e.g. gf::BlurEffect or gf::BloomEffect.
+   *
+   * The offscreen textures come from a pool of targets (see
+   * getTargetPool()). When the window is resized, they are reallocated
+   * only once the size has been stable for a while (see setResizeDelay()).
+   * In the meantime, the scene is drawn at the previous size and stretched
+   * to the window, so that a continuous resize of the window does not
+   * reallocate the textures at each event.
+   *
+   * @sa gf::Effect, gf::MultiPassEffect, gf::RenderTargetPool
    */
   class GF_API RenderPipeline : public RenderTarget {
   public:
@@ -83,12 +129,28 @@ inline namespace v1 {
     /**
      * @brief Add an effect to the pipeline
      *
+     * The effects must be changed before anything is drawn in the frame,
+     * as the framebuffer where the scene is drawn may change.
+     *
      * @param effect The effect
      */
     void addEffect(Effect& effect);
 
+    /**
+     * @brief Add a multi-pass effect to the pipeline
+     *
+     * The effects must be changed before anything is drawn in the frame,
+     * as the framebuffer where the scene is drawn may change.
+     *
+     * @param effect The multi-pass effect
+     */
+    void addEffect(MultiPassEffect& effect);
+
     /**
      * @brief Clear the pipeline
+     *
+     * The effects must be changed before anything is drawn in the frame,
+     * as the framebuffer where the scene is drawn may change.
      */
     void clearEffects();
 
@@ -97,6 +159,9 @@ inline namespace v1 {
      *
      * This function must be called when the window change its size, before
      * anything is drawn on the target. You can do it in the event processing.
+     * The offscreen textures are reallocated, and onFramebufferResize() is
+     * called, when the size has been stable for the resize delay. Without
+     * effects, onFramebufferResize() is called immediately.
      *
      * ~~~{.cc}
      * gf::Event event;
@@ -121,29 +186,94 @@ inline namespace v1 {
      */
     void display();
 
+    /**
+     * @brief Set the delay before the reallocation after a resize
+     *
+     * A zero delay reallocates the offscreen textures in `resized()`. The
+     * default delay is 100 milliseconds.
+     *
+     * @param delay The time the size must be stable
+     *
+     * @sa resized()
+     */
+    void setResizeDelay(Time delay) {
+      m_resizeDelay = delay;
+    }
+
+    /**
+     * @brief Get the delay before the reallocation after a resize
+     *
+     * @return The time the size must be stable
+     */
+    Time getResizeDelay() const {
+      return m_resizeDelay;
+    }
+
+    /**
+     * @brief Get the pool of offscreen targets
+     *
+     * The pool can be used for the intermediate targets of multi-pass
+     * effects. It is collected at each call to `display()`.
+     *
+     * @return The pool of the pipeline
+     */
+    RenderTargetPool& getTargetPool() {
+      return m_pool;
+    }
+
+    /**
+     * @brief Draw a full-screen pass
+     *
+     * The whole source texture is drawn on the whole target with the
+     * effect. The target is cleared before. The source and the target may
+     * have different sizes, the texture is then scaled with its filter.
+     *
+     * This function is meant to be used in MultiPassEffect::apply().
+     *
+     * @param effect The effect of the pass
+     * @param source The texture to process
+     * @param target The target of the pass, `nullptr` for the window
+     * @param mode The blend mode of the pass
+     */
+    void drawPass(Effect& effect, const Texture& source, const RenderTargetPool::Target *target, const BlendMode& mode = BlendNone);
+
   protected:
     /**
      * @brief Callback when the screen has just been resized
      *
-     * This function is called by resized() with the correct size.
+     * This function is called when the offscreen textures are reallocated
+     * after a call to resized(), with the correct size.
      *
      * @param size The new framebuffer size
      */
     virtual void onFramebufferResize(Vector2u size);
 
   private:
-    Window& m_window;
+    void bindFrameTarget();
+    void releaseBuffers();
+    void applyResize();
 
-    struct TextureBuffer {
-      Texture texture;
-      unsigned name;
-    };
+  private:
+    Window& m_window;
 
-    TextureBuffer m_buffers[2];
+    RenderTargetPool m_pool;
+    RenderTargetPool::Target *m_buffers[2];
     int m_current;
+    Vector2u m_bufferSize;
+    bool m_inPass;
+    Vector2u m_passSize;
+
+    bool m_resizePending;
+    Clock m_resizeClock;
+    Time m_resizeDelay;
+
+    struct Step {
+      Effect *effect;
+      MultiPassEffect *multiPassEffect;
+    };
 
-    DefaultEffect m_defaultEffect;
-    std::vector<Effect*> m_effects;
+    PostProcessing m_postProcessing;
+    std::vector<Step> m_effects;
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,269 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_RENDER_QUEUE_H
+#define GF_RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "Blend.h"
+#include "Portability.h"
+#include "PrimitiveType.h"
+#include "RenderStates.h"
+#include "Vertex.h"
+#include "View.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  class BareTexture;
+  class RenderTarget;
+  class Shader;
+
+  /**
+   * @ingroup graphics
+   * @brief A queue of draw commands
+   *
+   * A render queue collects the draw calls of a render target, and draws
+   * them later, in a different order, so that the consecutive compatible
+   * draw calls are merged in a single draw call.
+   *
+   * The queue is attached to a render target with
+   * gf::RenderTarget::setRenderQueue(). Then, the draw calls with client
+   * vertices (gf::Vertex or gf::PackedVertex, with or without 16-bit
+   * indices) are recorded instead of being drawn. It is the case of
+   * gf::Sprite, gf::Shape, gf::Text and most of the drawables of gf, so
+   * they do not need any change. The other draw calls (vertex buffers,
+   * instances, etc.) flush the queue before drawing.
+   *
+   * ~~~{.cc}
+   * gf::RenderQueue queue;
+   * renderer.setRenderQueue(&queue);
+   *
+   * renderer.clear();
+   *
+   * queue.setLayer(0);
+   * mainEntities.render(renderer);
+   *
+   * queue.setLayer(1);
+   * hudEntities.render(renderer);
+   *
+   * queue.flush(renderer);
+   * renderer.display();
+   * ~~~
+   *
+   * Each command has a 64-bit key made of its layer, its view and its
+   * submission order. The commands are sorted on this key when the queue is
+   * flushed, so the layers are drawn in increasing order and, in a layer,
+   * the commands are drawn in the order of submission.
+   *
+   * Then, the consecutive commands that share the same view, shader,
+   * texture, blend mode, line width and vertex format are drawn in a single
+   * draw call. The vertices are transformed on the CPU at submission, so
+   * that commands with different transforms can be merged. The vertices
+   * keep their format, so the colors of gf::Vertex are not quantized.
+   *
+   * With state sorting (see setStateSorting()), the opaque commands (with
+   * gf::BlendNone) of a layer are drawn first, grouped by shader, texture
+   * and blend mode, so that more commands can be merged. The translucent
+   * commands are still drawn in the order of submission after them. A 2D
+   * target has no depth buffer, so two opaque commands that overlap may be
+   * drawn in another order than the order of submission: state sorting is
+   * only correct when the opaque commands of a layer do not overlap.
+   *
+   * The queue only keeps a pointer to the shader and the texture of each
+   * command. The uniforms of a shader are read when the queue is flushed,
+   * not when the command is submitted: if a uniform of a shared gf::Shader
+   * changes between two submissions, both commands are drawn with the last
+   * value. In this case, use a different shader for each value, or flush
+   * the queue before changing the uniform. The same goes for the content of
+   * a texture.
+   *
+   * The queue is flushed when the render target is cleared or displayed.
+   *
+   * @sa gf::RenderTarget::setRenderQueue()
+   */
+  class GF_API RenderQueue {
+  public:
+    /**
+     * @brief Default constructor
+     */
+    RenderQueue();
+
+    /**
+     * @brief Deleted copy constructor
+     */
+    RenderQueue(const RenderQueue&) = delete;
+
+    /**
+     * @brief Deleted copy assignment
+     */
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    /**
+     * @brief Set the layer of the next commands
+     *
+     * The layers are drawn in increasing order. The default layer is 0.
+     *
+     * @param layer The layer, in @f$ [-32768, 32767] @f$
+     * @sa getLayer()
+     */
+    void setLayer(int layer) {
+      m_layer = layer;
+    }
+
+    /**
+     * @brief Get the layer of the next commands
+     *
+     * @return The current layer
+     * @sa setLayer()
+     */
+    int getLayer() const {
+      return m_layer;
+    }
+
+    /**
+     * @brief Enable or disable the state sorting of the opaque commands
+     *
+     * The opaque commands submitted after this call are grouped by shader,
+     * texture and blend mode instead of being drawn in the order of
+     * submission. Overlapping opaque commands may then be reordered.
+     *
+     * State sorting is disabled by default.
+     *
+     * @param stateSorting True to enable state sorting
+     * @sa isStateSorting()
+     */
+    void setStateSorting(bool stateSorting) {
+      m_stateSorting = stateSorting;
+    }
+
+    /**
+     * @brief Tell whether state sorting is enabled
+     *
+     * @return True if state sorting is enabled
+     * @sa setStateSorting()
+     */
+    bool isStateSorting() const {
+      return m_stateSorting;
+    }
+
+    /**
+     * @brief Get the number of commands in the queue
+     *
+     * @return The number of commands waiting to be drawn
+     */
+    std::size_t getCommandCount() const {
+      return m_commands.size();
+    }
+
+    /**
+     * @brief Get the number of draw calls of the last flush
+     *
+     * @return The number of draw calls issued by the last call to `flush()`
+     */
+    std::size_t getDrawCount() const {
+      return m_drawCount;
+    }
+
+    /**
+     * @brief Draw all the commands
+     *
+     * The commands are sorted, merged and drawn to the target, then the
+     * queue is cleared.
+     *
+     * @param target The target where to draw the commands
+     */
+    void flush(RenderTarget& target);
+
+    /**
+     * @brief Remove all the commands without drawing them
+     */
+    void clear();
+
+  private:
+    friend class RenderTarget;
+
+    void submit(RenderTarget& target, const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states);
+
+    std::size_t getViewIndex(const View& view);
+    std::size_t getShaderIndex(Shader *shader);
+    std::size_t getTextureIndex(const BareTexture *texture);
+    std::size_t getModeIndex(const BlendMode& mode, float lineWidth);
+
+  private:
+    struct Command {
+      uint32_t view;
+      uint32_t shader;
+      uint32_t texture;
+      uint32_t mode;
+      PrimitiveType type;
+      bool packed;
+      std::size_t firstVertex;
+      std::size_t vertexCount;
+      std::size_t firstIndex;
+      std::size_t indexCount;
+    };
+
+    struct SortItem {
+      uint64_t key;
+      uint32_t index;
+    };
+
+    struct Mode {
+      BlendMode blend;
+      float lineWidth;
+    };
+
+    int m_layer;
+    bool m_stateSorting;
+    bool m_flushing;
+    std::size_t m_drawCount;
+
+    std::vector<Command> m_commands;
+    std::vector<SortItem> m_items;
+    std::vector<SortItem> m_sortBuffer;
+
+    std::vector<View> m_views;
+    std::vector<Shader *> m_shaders;
+    std::vector<const BareTexture *> m_textures;
+    std::map<const BareTexture *, std::size_t> m_textureIndices;
+    std::vector<Mode> m_modes;
+
+    std::vector<Vertex> m_vertices;
+    std::vector<PackedVertex> m_packedVertices;
+    std::vector<uint32_t> m_indices;
+
+    std::vector<Vertex> m_drawVertices;
+    std::vector<PackedVertex> m_drawPackedVertices;
+    std::vector<uint32_t> m_drawIndices;
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_RENDER_QUEUE_H
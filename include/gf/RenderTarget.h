@@ -24,7 +24,9 @@
 #ifndef GF_RENDER_TARGET_H
 #define GF_RENDER_TARGET_H
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "Image.h"
 #include "Matrix.h"
@@ -41,8 +43,45 @@ inline namespace v1 {
 #endif
 
   class Drawable;
+  class RenderQueue;
   class VertexBuffer;
   struct Vertex;
+  struct PackedVertex;
+  struct BatchVertex;
+  struct InstanceData;
+  struct VertexFormat;
+
+  /**
+   * @ingroup graphics
+   * @brief Counters of the OpenGL state cache
+   *
+   * @sa gf::RenderTarget::getStateCacheCounters()
+   */
+  struct GF_API StateCacheCounters {
+    std::size_t changed = 0; ///< Number of state changes sent to OpenGL
+    std::size_t skipped = 0; ///< Number of redundant state changes that were skipped
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief Statistics of the rendering
+   *
+   * The statistics count the commands that are actually sent to OpenGL,
+   * the redundant state changes skipped by the state cache are not
+   * counted.
+   *
+   * @sa gf::RenderTarget::getStats()
+   */
+  struct GF_API RenderStats {
+    std::size_t drawCalls = 0; ///< Number of draw calls
+    std::size_t vertices = 0; ///< Number of vertices (or indices) submitted in the draw calls, for all the instances
+    std::size_t textureBinds = 0; ///< Number of texture binds
+    std::size_t shaderSwitches = 0; ///< Number of shader program switches
+    std::size_t bufferUploads = 0; ///< Number of uploads to vertex or index buffers
+    std::size_t bufferUploadSize = 0; ///< Size of the uploads to vertex or index buffers, in bytes
+    std::size_t textureUploads = 0; ///< Number of uploads to textures
+    std::size_t framebufferSwitches = 0; ///< Number of framebuffer switches
+  };
 
   /**
    * @ingroup graphics
@@ -154,9 +193,69 @@ inline namespace v1 {
      */
     void draw(const Vertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states = RenderStates());
 
+    /**
+     * @brief Draw primitives defined by an array of packed vertices
+     *
+     * @param vertices Pointer to the vertices
+     * @param count Number of vertices in the array
+     * @param type Type of primitives to draw
+     * @param states Render states to use for drawing
+     *
+     * @sa gf::PackedVertex
+     */
+    void draw(const PackedVertex *vertices, std::size_t count, PrimitiveType type, const RenderStates& states = RenderStates());
+
+    /**
+     * @brief Draw primitives defined by an array of packed vertices and their indices
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     * @param states Render states to use for drawing
+     *
+     * @sa gf::PackedVertex
+     */
+    void draw(const PackedVertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states = RenderStates());
+
+    /**
+     * @brief Draw primitives defined by an array of vertices and their 32-bit indices
+     *
+     * If the indices fit in 16 bits, they are sent as 16-bit indices.
+     * Otherwise, they are sent as 32-bit indices if the context supports
+     * them (`GL_OES_element_index_uint`). If it does not, the primitives are
+     * split in as few draw calls as possible with 16-bit indices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     * @param states Render states to use for drawing
+     */
+    void draw(const Vertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states = RenderStates());
+
+    /**
+     * @brief Draw primitives defined by an array of packed vertices and their 32-bit indices
+     *
+     * See the previous function for the handling of the indices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     * @param states Render states to use for drawing
+     *
+     * @sa gf::PackedVertex
+     */
+    void draw(const PackedVertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states = RenderStates());
+
     /**
      * @brief Draw primitives defined by an array of vertices
      *
+     * All the primitives are drawn in a single draw call, with
+     * `GL_EXT_multi_draw_arrays` if the context provides it, or by merging
+     * the primitives in a single list otherwise.
+     *
      * @param vertices Pointer to the vertices
      * @param first Array of starting indices
      * @param count Array of number of vertices
@@ -169,6 +268,10 @@ inline namespace v1 {
     /**
      * @brief Draw primitives defined by an array of vertices and their indices
      *
+     * All the primitives are drawn in a single draw call, with
+     * `GL_EXT_multi_draw_arrays` if the context provides it, or by merging
+     * the primitives in a single list otherwise.
+     *
      * @param vertices Pointer to the vertices
      * @param indices Array of pointers to the indices
      * @param count Array of number of indices
@@ -186,6 +289,70 @@ inline namespace v1 {
      */
     void draw(const VertexBuffer& buffer, const RenderStates& states = RenderStates());
 
+    /**
+     * @brief Draw many instances of a vertex buffer to the render target
+     *
+     * The geometry of the buffer is drawn once for each instance, with the
+     * transformation and the color of the instance. The transformation of
+     * the instance is applied before the transformation of the render
+     * states.
+     *
+     * If the context supports instanced arrays, all the instances are drawn
+     * in a single draw call. If no shader is given in the render states, a
+     * default shader is used. A custom shader must define the
+     * `a_instanceRow0`, `a_instanceRow1` and `a_instanceColor` attributes
+     * (see gf::InstanceData::getFormat()).
+     *
+     * Otherwise, the instances are expanded in the client memory and drawn
+     * with the shader of the render states, in a single draw call for
+     * points, lines, triangles and quads.
+     *
+     * @param buffer A vertex buffer containing a geometry
+     * @param instances Pointer to the instances
+     * @param count Number of instances
+     * @param states Render states to use for drawing
+     *
+     * @sa gf::InstanceData
+     */
+    void drawInstanced(const VertexBuffer& buffer, const InstanceData *instances, std::size_t count, const RenderStates& states = RenderStates());
+
+    /**
+     * @brief Maximum number of texture slots for batch vertices
+     */
+    static constexpr std::size_t MaxTextureSlots = 8;
+
+    /**
+     * @brief Get the number of texture slots for batch vertices
+     *
+     * This is the minimum of gf::RenderTarget::MaxTextureSlots and the number
+     * of texture units of the fragment shader.
+     *
+     * @return The number of textures that can be given to a draw call with
+     * batch vertices
+     */
+    std::size_t getTextureSlotCount() const {
+      return m_textureSlotCount;
+    }
+
+    /**
+     * @brief Draw primitives defined by an array of batch vertices
+     *
+     * Each vertex uses the texture at its texture slot. If no shader is
+     * given in the render states, a default shader is used. A custom shader
+     * must define a `a_textureSlot` attribute and a `u_textureN` sampler for
+     * each slot. The texture of the render states is ignored.
+     *
+     * @param vertices Pointer to the vertices
+     * @param count Number of vertices in the array
+     * @param type Type of primitives to draw
+     * @param textures Array of textures, indexed by the texture slots
+     * @param textureCount Number of textures, at most getTextureSlotCount()
+     * @param states Render states to use for drawing
+     *
+     * @sa getTextureSlotCount(), gf::BatchVertex
+     */
+    void draw(const BatchVertex *vertices, std::size_t count, PrimitiveType type, const BareTexture *const *textures, std::size_t textureCount, const RenderStates& states = RenderStates());
+
     /**
      * @brief Draw a drawable object to the render target
      *
@@ -367,6 +534,118 @@ inline namespace v1 {
 
     /** @} */
 
+    /**
+     * @name Render queue
+     * @{
+     */
+
+    /**
+     * @brief Attach a render queue to the target
+     *
+     * While a queue is attached, the draw calls with client vertices are
+     * recorded in the queue, and drawn when the queue is flushed. The
+     * previous queue, if any, is flushed.
+     *
+     * @param queue The render queue or `nullptr` to draw immediately
+     *
+     * @sa gf::RenderQueue
+     */
+    void setRenderQueue(RenderQueue *queue);
+
+    /**
+     * @brief Get the attached render queue
+     *
+     * @return The render queue or `nullptr`
+     */
+    RenderQueue *getRenderQueue() const {
+      return m_renderQueue;
+    }
+
+    /** @} */
+
+    /**
+     * @name OpenGL state cache
+     * @{
+     */
+
+    /**
+     * @brief Get the counters of the OpenGL state cache
+     *
+     * The render targets only send the state changes (blend mode,
+     * viewport, shader, textures, buffers, vertex attributes) that are
+     * different from the current state of the OpenGL context. The
+     * counters indicate how many changes were sent to OpenGL and how
+     * many were skipped since the last reset.
+     *
+     * The OpenGL state belongs to the context, so the cache and its
+     * counters are shared by all the render targets.
+     *
+     * @return The counters of the cache
+     *
+     * @sa resetStateCacheCounters()
+     */
+    StateCacheCounters getStateCacheCounters() const;
+
+    /**
+     * @brief Reset the counters of the OpenGL state cache
+     *
+     * This function is usually called once every frame.
+     *
+     * @sa getStateCacheCounters()
+     */
+    void resetStateCacheCounters();
+
+    /**
+     * @brief Invalidate the OpenGL state cache
+     *
+     * You must call this function if you change the OpenGL state
+     * directly with OpenGL calls, so that the next draw sends all the
+     * states again.
+     */
+    void invalidateStateCache();
+
+    /** @} */
+
+    /**
+     * @name Statistics
+     * @{
+     */
+
+    /**
+     * @brief Get the statistics of the rendering
+     *
+     * The statistics are accumulated since the last reset. Like the
+     * OpenGL state cache, they are shared by all the render targets, as
+     * textures, shaders and buffers are not owned by a single target.
+     *
+     * ~~~{.cc}
+     * renderer.resetStats();
+     *
+     * // draw the frame
+     *
+     * gf::RenderStats stats = renderer.getStats();
+     * gf::Log::debug(gf::Log::Graphics, "%zu draw calls, %zu vertices\n", stats.drawCalls, stats.vertices);
+     * ~~~
+     *
+     * The time spent by the GPU can be measured with gf::GpuTimer.
+     *
+     * @return The statistics of the rendering
+     *
+     * @sa resetStats()
+     */
+    RenderStats getStats() const;
+
+    /**
+     * @brief Reset the statistics of the rendering
+     *
+     * This function is usually called once every frame.
+     *
+     * @sa getStats()
+     */
+    void resetStats();
+
+    /** @} */
+
   protected:
     /**
      * @brief Performs the common initialization step after creation
@@ -376,6 +655,13 @@ inline namespace v1 {
      */
     void initialize();
 
+    /**
+     * @brief Reset the views after a change of size
+     *
+     * The derived classes must call this function when the size of an
+     * initialized target changes.
+     */
+    void initializeViews();
 
     /**
      * @brief Capture the given framebuffer
@@ -384,26 +670,79 @@ inline namespace v1 {
      */
     Image captureFramebuffer(unsigned name) const;
 
+    /**
+     * @brief Draw the commands of the attached render queue
+     *
+     * The derived classes must call this function before displaying the
+     * target.
+     */
+    void flushRenderQueue();
+
   private:
-    void initializeViews();
     void initializeShader();
     void initializeTexture();
 
-    struct Locations {
-      int positionLoc;
-      int colorLoc;
-      int texCoordsLoc;
+    struct StreamBuffer {
+      unsigned name = 0;
+      std::size_t capacity = 0;
+      std::size_t offset = 0;
     };
 
-    void drawStart(const Vertex *vertices, const RenderStates& states, Locations& locations);
-    void drawFinish(const Locations& locations);
+    std::size_t streamVertices(const void *vertices, std::size_t count, const VertexFormat& format);
+    std::size_t streamIndices(const uint16_t *indices, std::size_t count);
+    std::size_t streamIndices(const uint32_t *indices, std::size_t count);
+    unsigned getStreamName(StreamBuffer& stream, std::size_t capacity);
+    std::size_t streamData(StreamBuffer& stream, unsigned target, const void *data, std::size_t size);
+
+    struct QuadIndexBuffer {
+      unsigned name = 0;
+      std::size_t quadCount = 0;
+    };
+
+    struct TextureSlots {
+      const BareTexture *const *textures;
+      std::size_t count;
+    };
+
+    struct Instances {
+      std::size_t offset; // in the vertex stream
+      std::size_t count;
+    };
+
+    void bindQuadIndices(QuadIndexBuffer& buffer, std::size_t quadCount, bool large);
+    void drawQuads(std::size_t offset, std::size_t count, const VertexFormat& format, const RenderStates& states, const TextureSlots *slots = nullptr, const Instances *instances = nullptr);
+
+    void drawVertices(const void *vertices, std::size_t count, const VertexFormat& format, PrimitiveType type, const RenderStates& states, const TextureSlots *slots = nullptr);
+    void drawIndexedVertices(const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states);
+    void drawIndexedVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states);
+    void drawBuffer(const VertexBuffer& buffer, const RenderStates& states, const Instances *instances);
+
+    void drawExpandedInstances(const VertexBuffer& buffer, const InstanceData *instances, std::size_t count, const RenderStates& states);
+
+    void drawStart(std::size_t offset, const VertexFormat& format, const RenderStates& states, const TextureSlots *slots = nullptr, const Instances *instances = nullptr);
 
   private:
     View m_view;
     View m_defaultView;
     Shader m_defaultShader;
     Shader m_defaultAlphaShader;
+    Shader m_defaultBatchShader;
+    Shader m_defaultInstancedShader;
+    Shader m_defaultInstancedAlphaShader;
     Texture m_defaultTexture;
+    std::size_t m_textureSlotCount = 0;
+    RenderQueue *m_renderQueue = nullptr;
+    StreamBuffer m_vertexStream;
+    StreamBuffer m_indexStream;
+    QuadIndexBuffer m_quadIndices;
+    QuadIndexBuffer m_quadIndicesLarge;
+    std::vector<uint8_t> m_expandedVertices;
+    std::vector<uint16_t> m_shortIndices;
+    std::vector<uint32_t> m_listIndices;
+    std::vector<uint32_t> m_multiIndices;
+    std::vector<int> m_multiCounts;
+    std::vector<const void *> m_multiOffsets;
+    std::vector<uint8_t> m_splitVertices;
 
   };
 
@@ -0,0 +1,205 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_RENDER_TARGET_POOL_H
+#define GF_RENDER_TARGET_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Portability.h"
+#include "Texture.h"
+#include "Vector.h"
+
+namespace gf {
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+inline namespace v1 {
+#endif
+
+  /**
+   * @ingroup graphics
+   * @brief A pool of offscreen targets
+   *
+   * An offscreen target is a framebuffer with a color texture. Creating
+   * one is costly: the storage of the texture must be allocated by the
+   * driver. The pool keeps the targets that are not used anymore and hands
+   * them out again when a target of the same size is asked. The targets of
+   * a multi-pass effect can then be acquired and released every frame
+   * without any allocation.
+   *
+   * The targets that stay unused for some frames (see setMaxIdleFrames())
+   * are destroyed in `collect()`, that must be called once per frame. If
+   * no idle target has the right size, a target of another size that was
+   * idle during the previous frame is reallocated before a new one is
+   * created.
+   *
+   * All the targets have the RGBA format, which is the only color format
+   * that OpenGL ES 2.0 can render to.
+   *
+   * @sa gf::RenderPipeline
+   */
+  class GF_API RenderTargetPool {
+  public:
+    /**
+     * @brief An offscreen target of the pool
+     */
+    class GF_API Target {
+    public:
+      /**
+       * @brief Get the texture of the target
+       *
+       * @return The color texture
+       */
+      const Texture& getTexture() const {
+        return m_texture;
+      }
+
+      /**
+       * @brief Get the size of the target
+       *
+       * @return The size of the texture
+       */
+      Vector2u getSize() const {
+        return m_texture.getSize();
+      }
+
+      /**
+       * @brief Get the internal representation of the target
+       *
+       * This function is for internal use only.
+       *
+       * @return The OpenGL name of the framebuffer
+       */
+      unsigned getFramebuffer() const {
+        return m_framebuffer;
+      }
+
+    private:
+      friend class RenderTargetPool;
+
+      Texture m_texture;
+      unsigned m_framebuffer = 0;
+      bool m_used = false;
+      unsigned m_idleFrames = 0;
+    };
+
+    /**
+     * @brief Constructor
+     */
+    RenderTargetPool();
+
+    /**
+     * @brief Destructor
+     *
+     * All the targets are destroyed.
+     */
+    ~RenderTargetPool();
+
+    /**
+     * @brief Deleted copy constructor
+     */
+    RenderTargetPool(const RenderTargetPool&) = delete;
+
+    /**
+     * @brief Deleted copy assignment
+     */
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    /**
+     * @brief Acquire a target
+     *
+     * The content of the target is undefined. The texture of the target has
+     * the smooth filter and is not repeated.
+     *
+     * @param size The size of the target
+     * @return A target or `nullptr` if it could not be created
+     *
+     * @sa release()
+     */
+    Target *acquire(Vector2u size);
+
+    /**
+     * @brief Release a target
+     *
+     * The target goes back to the pool and must not be used anymore.
+     *
+     * @param target The target, can be `nullptr`
+     *
+     * @sa acquire()
+     */
+    void release(Target *target);
+
+    /**
+     * @brief Destroy the targets that are idle for too long
+     *
+     * This function must be called once per frame.
+     */
+    void collect();
+
+    /**
+     * @brief Destroy all the idle targets
+     */
+    void clear();
+
+    /**
+     * @brief Set the number of frames before an idle target is destroyed
+     *
+     * The default is 60 frames.
+     *
+     * @param frames The number of frames
+     */
+    void setMaxIdleFrames(unsigned frames) {
+      m_maxIdleFrames = frames;
+    }
+
+    /**
+     * @brief Get the number of frames before an idle target is destroyed
+     *
+     * @return The number of frames
+     */
+    unsigned getMaxIdleFrames() const {
+      return m_maxIdleFrames;
+    }
+
+    /**
+     * @brief Get the number of targets in the pool
+     *
+     * @return The number of targets, used or idle
+     */
+    std::size_t getTargetCount() const {
+      return m_targets.size();
+    }
+
+  private:
+    bool allocate(Target& target, Vector2u size);
+    void destroy(Target& target);
+
+  private:
+    std::vector<std::unique_ptr<Target>> m_targets;
+    unsigned m_maxIdleFrames;
+  };
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+}
+#endif
+}
+
+#endif // GF_RENDER_TARGET_POOL_H
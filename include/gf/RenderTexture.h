@@ -123,6 +123,10 @@ inline namespace v1 {
      * an invalid state, thus it is mandatory to call it before
      * doing anything with the render-texture.
      *
+     * The render-texture can be created again with another size. Its
+     * framebuffer is kept, and so is the storage of its texture if the size
+     * does not change. The views are reset in any case.
+     *
      * @param size Size of the render-texture
      *
      * @return True if creation has been successful
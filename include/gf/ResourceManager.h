@@ -26,9 +26,11 @@
 #include <memory>
 
 #include "AssetManager.h"
+#include "AtlasPacker.h"
 #include "Font.h"
 #include "Portability.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
 
 namespace gf {
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -122,7 +124,20 @@ inline namespace v1 {
    * @ingroup game
    * @brief A ressource manager
    *
-   * @sa gf::ResourceCache
+   * The textures can be loaded in their own texture (see getTexture()) or
+   * packed with other images in shared atlas textures (see
+   * getPackedTexture()). The sprites using packed textures share the same
+   * texture and can be batched together:
+   *
+   * ~~~{.cc}
+   * const gf::TextureAtlas *atlas = resources.getPackedTexture("hero.png");
+   *
+   * gf::Sprite sprite;
+   * sprite.setTexture(*atlas->getTexture());
+   * sprite.setTextureRect(atlas->getTextureRect("hero.png"));
+   * ~~~
+   *
+   * @sa gf::ResourceCache, gf::AtlasPacker
    */
   class GF_API ResourceManager : public AssetManager {
   public:
@@ -151,9 +166,36 @@ inline namespace v1 {
       return m_fonts.getResource(*this, path);
     }
 
+    /**
+     * @brief Get a texture packed in an atlas
+     *
+     * The image is loaded and packed in a page of the atlas packer of the
+     * manager, the first time it is requested. The name of the image in the
+     * returned atlas is the path, as given to this function.
+     *
+     * @param path A path to the image
+     * @return The atlas of the page of the image or `nullptr` if it has not
+     * been found or if it is too big for a page
+     *
+     * @sa getAtlasPacker()
+     */
+    const TextureAtlas *getPackedTexture(const Path& path);
+
+    /**
+     * @brief Get the atlas packer of the manager
+     *
+     * @return The atlas packer used for the packed textures
+     *
+     * @sa getPackedTexture()
+     */
+    AtlasPacker& getAtlasPacker() {
+      return m_packer;
+    }
+
   private:
     ResourceCache<Texture> m_textures;
     ResourceCache<Font> m_fonts;
+    AtlasPacker m_packer;
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
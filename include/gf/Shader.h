@@ -26,8 +26,10 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "Filesystem.h"
+#include "Id.h"
 #include "Matrix.h"
 #include "Portability.h"
 #include "Texture.h"
@@ -94,6 +96,25 @@ inline namespace v1 {
    * shader.setUniform("overlay", texture); // texture is a gf::Texture
    * ~~~
    *
+   * The locations of the uniforms are queried once, when the shader is
+   * loaded. Every setUniform() overload also exists with a gf::Id
+   * instead of the name, so that the name can be hashed at compile time
+   * with the user-defined literal `_id`:
+   *
+   * ~~~
+   * shader.setUniform("offset"_id, 2.0f);
+   * ~~~
+   *
+   * The name can not be recovered from its id, so if the uniform does not
+   * exist, the warning only gives the id. The warnings for the uniforms
+   * and attributes of the library (`u_texture`, `a_position`, etc.) give
+   * their name.
+   *
+   * The values of the uniforms are kept in the shader and are only sent
+   * to the graphics card when the shader is used for drawing, and only if
+   * they have changed since the last time. So setting a uniform is cheap
+   * and can be done every frame.
+   *
    * To apply a shader to a drawable, you must pass it as part of the
    * gf::RenderStates in the call to @ref RenderTarget::draw() function:
    *
@@ -371,6 +392,71 @@ inline namespace v1 {
      */
     void setUniform(const std::string& name, const BareTexture& tex);
 
+    /**
+     * @brief Specify value for a `float` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param val Value of the `float` scalar
+     */
+    void setUniform(Id id, float val);
+
+    /**
+     * @brief Specify value for a `int` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param val Value of the `int` scalar
+     */
+    void setUniform(Id id, int val);
+
+    /**
+     * @brief Specify value for a `vec2` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param vec Value of the `vec2` vector
+     */
+    void setUniform(Id id, const Vector2f& vec);
+
+    /**
+     * @brief Specify value for a `vec3` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param vec Value of the `vec3` vector
+     */
+    void setUniform(Id id, const Vector3f& vec);
+
+    /**
+     * @brief Specify value for a `vec4` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param vec Value of the `vec4` vector
+     */
+    void setUniform(Id id, const Vector4f& vec);
+
+    /**
+     * @brief Specify value for a `mat3` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param mat Value of the `mat3` matrix
+     */
+    void setUniform(Id id, const Matrix3f& mat);
+
+    /**
+     * @brief Specify value for a `mat4` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param mat Value of the `mat4` matrix
+     */
+    void setUniform(Id id, const Matrix4f& mat);
+
+    /**
+     * @brief Specify a texture for a `sampler2D` uniform
+     *
+     * @param id Identifier of the name of the uniform variable in GLSL
+     * @param tex Value of the `sampler2D` texture
+     * @sa setUniform(const std::string&, const BareTexture&)
+     */
+    void setUniform(Id id, const BareTexture& tex);
+
     /** @} */
 
     /**
@@ -378,6 +464,9 @@ inline namespace v1 {
      *
      * This function is for internal use only.
      *
+     * The values of the uniforms that have changed are sent to the
+     * graphics card and the textures are bound to their texture units.
+     *
      * @param shader Shader to bind, can be null to use no shader
      */
 
@@ -385,16 +474,48 @@ inline namespace v1 {
 
   private:
     friend class RenderTarget;
+
+    enum class UniformType {
+      None,
+      Float,
+      Int,
+      Vec2,
+      Vec3,
+      Vec4,
+      Mat3,
+      Mat4,
+    };
+
+    struct Uniform {
+      int location;
+      UniformType type;
+      mutable bool dirty;
+      float values[16];
+      int integer;
+      int unit;
+      const BareTexture *texture;
+    };
+
     bool compile(const char *vertexShaderCode, const char *fragmentShaderCode);
-    int getUniformLocation(const std::string& name);
+    void queryLocations();
+    void setUniformValues(Uniform *uniform, UniformType type, const float *values, std::size_t count);
+    void setUniformInteger(Uniform *uniform, int integer);
+    void setUniformTexture(Uniform *uniform, const BareTexture& tex);
+    void uploadUniforms() const;
+    Uniform *getUniform(const std::string& name);
+    // the name is only for the message when the uniform is missing, it can be null
+    Uniform *getUniform(Id id, const char *name);
     int getAttributeLocation(const std::string& name);
-
-    struct Guard;
+    int getAttributeLocation(Id id, const char *name);
 
   private:
     unsigned m_program;
+    // the upload of the pending uniforms does not change the observable state
+    mutable bool m_dirty;
 
-    std::map<int, const BareTexture *> m_textures;
+    std::map<Id, std::size_t> m_uniformIndices;
+    std::vector<Uniform> m_uniforms;
+    std::map<Id, int> m_attributes;
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
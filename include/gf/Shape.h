@@ -279,6 +279,17 @@ inline namespace v1 {
      */
     VertexBuffer commitGeometry() const;
 
+    /**
+     * @brief Update a buffer with the current geometry
+     *
+     * The data of the buffer is replaced in place, so that a buffer can be
+     * refreshed each time the geometry changes, without a new allocation
+     * if its storage is large enough.
+     *
+     * @param buffer The buffer to update
+     */
+    void commitGeometry(VertexBuffer& buffer) const;
+
     /**
      * @brief Create a buffer with the current outline geometry
      *
@@ -289,6 +300,17 @@ inline namespace v1 {
      */
     VertexBuffer commitOutlineGeometry() const;
 
+    /**
+     * @brief Update a buffer with the current outline geometry
+     *
+     * The data of the buffer is replaced in place, so that a buffer can be
+     * refreshed each time the outline geometry changes, without a new allocation
+     * if its storage is large enough.
+     *
+     * @param buffer The buffer to update
+     */
+    void commitOutlineGeometry(VertexBuffer& buffer) const;
+
     virtual void draw(RenderTarget& target, RenderStates states) override;
 
   protected:
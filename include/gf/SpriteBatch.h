@@ -22,9 +22,15 @@
 #define GF_SPRITE_BATCH_H
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
+#include <map>
+#include <vector>
 
+#include "Color.h"
+#include "Matrix.h"
 #include "Portability.h"
+#include "Rect.h"
 #include "RenderStates.h"
 #include "Vertex.h"
 
@@ -33,8 +39,27 @@ namespace gf {
 inline namespace v1 {
 #endif
 
+  class BareTexture;
   class RenderTarget;
   class Sprite;
+  class Texture;
+
+  /**
+   * @ingroup graphics
+   * @brief The data of a sprite for a bulk draw in a sprite batch
+   *
+   * A sprite instance contains the same data as a gf::Sprite, without the
+   * gf::Transformable part: the final transformation is given directly.
+   *
+   * @sa gf::SpriteBatch::draw(const SpriteInstance *, std::size_t, const RenderStates&)
+   */
+  struct GF_API SpriteInstance {
+    const Texture *texture = nullptr; ///< The texture of the sprite, must not be `nullptr`
+    RectF textureRect = RectF(0.0f, 0.0f, 1.0f, 1.0f); ///< The texture rectangle, in texture coordinates
+    Matrix3f transform = identity<Matrix3f>(); ///< The transformation of the sprite
+    Color4f color = Color::White; ///< The color of the sprite
+    float depth = 0.0f; ///< The depth of the sprite for the depth sort modes
+  };
 
   /**
    * @ingroup graphics
@@ -56,6 +81,35 @@ inline namespace v1 {
    * batch.end();
    * ~~~
    *
+   * By default, the sprites are drawn immediately, in the order of the calls,
+   * and a new draw call is issued each time the texture or the render states
+   * change. If the sprites do not need to be drawn in this order, a sort mode
+   * can be given to `begin()`. The sprites are then collected and sorted in
+   * `end()` so that the sprites sharing the same render states and texture
+   * are drawn together:
+   *
+   * ~~~{.cc}
+   * batch.begin(gf::SpriteBatch::SortMode::Texture | gf::SpriteBatch::SortMode::BackToFront);
+   * batch.draw(background, 10.0f);
+   * batch.draw(hero, 1.0f);
+   * batch.draw(enemy, 1.0f);
+   * batch.end();
+   * ~~~
+   *
+   * The sort is stable: sprites with the same key are drawn in the order of
+   * the calls to `draw()`.
+   *
+   * In multi-textured mode (see `setMultiTextured()`), the batch binds
+   * several textures at once and each vertex indicates its texture, so that
+   * sprites with different textures can be drawn in the same draw call. A
+   * new draw call is only issued when all the texture slots of the render
+   * target are used (see gf::RenderTarget::getTextureSlotCount()).
+   *
+   * With culling (see `setCulling()`), the sprites that are outside the
+   * current view of the target are skipped before their vertices are
+   * computed. This is useful for large scenes where most of the sprites
+   * are not visible.
+   *
    * @sa gf::Sprite
    */
   class GF_API SpriteBatch {
@@ -67,10 +121,100 @@ inline namespace v1 {
      */
     SpriteBatch(RenderTarget& target);
 
+    /**
+     * @brief Enable or disable the multi-textured mode
+     *
+     * In this mode, the sprites are drawn with gf::BatchVertex and a custom
+     * shader given in the render states must handle the texture slots (see
+     * gf::RenderTarget::draw). This function must be called outside of
+     * `begin()` and `end()`.
+     *
+     * The mode is disabled by default.
+     *
+     * @param multiTextured True to enable the multi-textured mode
+     *
+     * @sa isMultiTextured()
+     */
+    void setMultiTextured(bool multiTextured);
+
+    /**
+     * @brief Tell whether the multi-textured mode is enabled
+     *
+     * @return True if the multi-textured mode is enabled
+     *
+     * @sa setMultiTextured()
+     */
+    bool isMultiTextured() const {
+      return m_multiTextured;
+    }
+
+    /**
+     * @brief Enable or disable the culling of the sprites
+     *
+     * When culling is enabled, the bounds of each sprite, transformed by
+     * the sprite transformation and the transformation of the render
+     * states, are tested against the current view of the target, taken
+     * in `begin()`. The rotation of the view is taken into account. The
+     * sprites that are outside the view are not drawn. This function
+     * must be called outside of `begin()` and `end()`.
+     *
+     * Culling is disabled by default.
+     *
+     * @param culling True to enable culling
+     *
+     * @sa isCulling(), getCulledCount()
+     */
+    void setCulling(bool culling) {
+      m_culling = culling;
+    }
+
+    /**
+     * @brief Tell whether culling is enabled
+     *
+     * @return True if culling is enabled
+     *
+     * @sa setCulling()
+     */
+    bool isCulling() const {
+      return m_culling;
+    }
+
+    /**
+     * @brief Get the number of culled sprites
+     *
+     * The count is reset in `begin()`.
+     *
+     * @return The number of sprites that were skipped since `begin()`
+     *
+     * @sa setCulling()
+     */
+    std::size_t getCulledCount() const {
+      return m_culledCount;
+    }
+
+    /**
+     * @brief The sort mode of the batch
+     *
+     * The modes can be combined with `operator|`. Any mode other than
+     * gf::SpriteBatch::SortMode::Immediate implies
+     * gf::SpriteBatch::SortMode::Deferred. When a depth mode is combined with
+     * gf::SpriteBatch::SortMode::Texture, the sprites are sorted by depth
+     * first, then by render states and texture.
+     */
+    enum class SortMode : unsigned {
+      Immediate   = 0x00, ///< Draw the sprites as they come (default)
+      Deferred    = 0x01, ///< Draw the sprites in `end()`, in the order of the calls
+      Texture     = 0x02, ///< Group the sprites by render states and texture
+      BackToFront = 0x04, ///< Sort the sprites by decreasing depth
+      FrontToBack = 0x08, ///< Sort the sprites by increasing depth
+    };
+
     /**
      * @brief Begin the batch
+     *
+     * @param mode The sort mode of the batch
      */
-    void begin();
+    void begin(SortMode mode = SortMode::Immediate);
 
     /**
      * @brief Add a sprite to the batch
@@ -83,25 +227,100 @@ inline namespace v1 {
      */
     void draw(Sprite& sprite, const RenderStates& states = RenderStates());
 
+    /**
+     * @brief Add a sprite to the batch with a depth
+     *
+     * The depth is only used when the batch sorts the sprites by depth (see
+     * gf::SpriteBatch::SortMode::BackToFront and
+     * gf::SpriteBatch::SortMode::FrontToBack).
+     *
+     * @param sprite The sprite to draw
+     * @param depth The depth of the sprite
+     * @param states The render states
+     */
+    void draw(Sprite& sprite, float depth, const RenderStates& states = RenderStates());
+
+    /**
+     * @brief Add many sprites to the batch
+     *
+     * The vertices of the sprites are computed in parallel for large arrays.
+     * The result is the same as calling `draw()` for each sprite in order.
+     * The draw calls are still issued on the calling thread.
+     *
+     * @param instances Pointer to the sprite instances
+     * @param count Number of sprite instances
+     * @param states The render states
+     */
+    void draw(const SpriteInstance *instances, std::size_t count, const RenderStates& states = RenderStates());
+
     /**
      * @brief End the batch
+     *
+     * In deferred mode, the sprites are sorted and drawn now.
      */
     void end();
 
-  private:
-    void renderBatch();
-
   private:
     static constexpr std::size_t MaxSpriteCount = 1024;
-    static constexpr std::size_t VerticesPerSprite = 6;
+    static constexpr std::size_t VerticesPerSprite = 4;
     static constexpr std::size_t MaxVertexCount = MaxSpriteCount * VerticesPerSprite;
 
+    struct DeferredSprite {
+      std::array<PackedVertex, VerticesPerSprite> vertices;
+      const Texture *texture;
+      std::size_t states;
+    };
+
+    struct SortItem {
+      uint64_t key;
+      uint32_t index;
+    };
+
+    bool isDeferred() const;
+    bool hasMode(SortMode mode) const;
+    std::size_t getStatesIndex(const RenderStates& states);
+    std::size_t getTextureIndex(const Texture *texture);
+    bool isVisible(const Matrix3f& transform, const Texture *texture, const RectF& textureRect, const RenderStates& states);
+    void addQuad(const PackedVertex *vertices, const Texture *texture, const RenderStates& states);
+    void addBatchQuad(const PackedVertex *vertices, const Texture *texture, const RenderStates& states);
+    void addDeferredQuad(const PackedVertex *vertices, const Texture *texture, float depth, const RenderStates& states);
+    void renderDeferred();
+    void renderBatch();
+
+  private:
     RenderTarget& m_target;
+    SortMode m_mode;
     RenderStates m_currentRenderStates;
     std::size_t m_count;
-    std::array<Vertex, MaxVertexCount> m_vertices;
+    std::array<PackedVertex, MaxVertexCount> m_vertices;
+
+    bool m_multiTextured;
+    std::vector<BatchVertex> m_batchVertices;
+    std::vector<const BareTexture *> m_textureSlots;
+
+    std::vector<DeferredSprite> m_deferredSprites;
+    std::vector<RenderStates> m_deferredStates;
+    std::size_t m_lastStates;
+    std::map<const Texture *, std::size_t> m_deferredTextures;
+    std::vector<SortItem> m_items;
+    std::vector<SortItem> m_sortBuffer;
+
+    std::vector<PackedVertex> m_instanceVertices;
+    std::vector<uint8_t> m_instanceVisible;
+
+    bool m_culling;
+    std::size_t m_culledCount;
+    Matrix3f m_viewTransform;
   };
 
+  /**
+   * @relates SpriteBatch
+   * @brief Combine two sort modes
+   */
+  constexpr SpriteBatch::SortMode operator|(SpriteBatch::SortMode lhs, SpriteBatch::SortMode rhs) {
+    return static_cast<SpriteBatch::SortMode>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+  }
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 }
 #endif
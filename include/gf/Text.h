@@ -338,6 +338,17 @@ inline namespace v1 {
      */
     VertexBuffer commitGeometry() const;
 
+    /**
+     * @brief Update a buffer with the current geometry
+     *
+     * The data of the buffer is replaced in place, so that a buffer can be
+     * refreshed each time the geometry changes, without a new allocation
+     * if its storage is large enough.
+     *
+     * @param buffer The buffer to update
+     */
+    void commitGeometry(VertexBuffer& buffer) const;
+
     /**
      * @brief Create a buffer with the current outline geometry
      *
@@ -348,6 +359,17 @@ inline namespace v1 {
      */
     VertexBuffer commitOutlineGeometry() const;
 
+    /**
+     * @brief Update a buffer with the current outline geometry
+     *
+     * The data of the buffer is replaced in place, so that a buffer can be
+     * refreshed each time the outline geometry changes, without a new allocation
+     * if its storage is large enough.
+     *
+     * @param buffer The buffer to update
+     */
+    void commitOutlineGeometry(VertexBuffer& buffer) const;
+
     virtual void draw(RenderTarget& target, RenderStates states) override;
 
   private:
@@ -373,12 +395,12 @@ inline namespace v1 {
     Font *m_font;
     unsigned m_characterSize;
     Color4f m_color;
-    VertexArray m_vertices;
+    PackedVertexArray m_vertices;
     RectF m_bounds;
 
     Color4f m_outlineColor;
     float m_outlineThickness;
-    VertexArray m_outlineVertices;
+    PackedVertexArray m_outlineVertices;
 
     float m_paragraphWidth;
     Alignment m_align;
@@ -25,6 +25,7 @@
 #define GF_TEXTURE_H
 
 #include <cstdint>
+#include <vector>
 
 #include "Filesystem.h"
 #include "Portability.h"
@@ -198,6 +199,57 @@ inline namespace v1 {
       return m_repeated;
     }
 
+    /**
+     * @brief Generate a mipmap using the current texture data
+     *
+     * Mipmaps are pre-computed chains of optimized textures. Each level of
+     * texture in a mipmap is generated by halving each of the previous
+     * level's dimensions. This is done until the final level has the size
+     * of 1x1. The textures generated in this process may make use of more
+     * advanced filters which might improve the visual quality of textures
+     * when they are applied to objects much smaller than they are. This is
+     * known as minification. Because fewer texels (texture elements) have
+     * to be sampled from when heavily minified, usage of mipmaps can also
+     * improve rendering performance in certain scenarios.
+     *
+     * When the texture has a mipmap, the smooth filter (see setSmooth())
+     * becomes a trilinear filter: the texels are interpolated in the two
+     * nearest levels, and then between the two levels.
+     *
+     * The mipmap is invalidated by any update of the texture and must be
+     * generated again. This function fails if the texture is compressed,
+     * or if its size is not a power of two and the `GL_OES_texture_npot`
+     * extension is not available.
+     *
+     * @return True if the mipmap was successfully generated
+     *
+     * @sa hasMipmap()
+     */
+    bool generateMipmap();
+
+    /**
+     * @brief Check if the texture has a mipmap
+     *
+     * @return True if the texture has a valid mipmap
+     *
+     * @sa generateMipmap()
+     */
+    bool hasMipmap() const noexcept {
+      return m_mipmap;
+    }
+
+    /**
+     * @brief Check if the texture is compressed
+     *
+     * A compressed texture is loaded from a KTX or DDS file in a format
+     * supported by the GPU. It can not be updated.
+     *
+     * @return True if the texture is stored compressed on the GPU
+     */
+    bool isCompressed() const noexcept {
+      return m_compressed;
+    }
+
     /**
      * @brief Update the whole texture from an array of pixels
      *
@@ -209,8 +261,8 @@ inline namespace v1 {
      * array, passing invalid arguments will lead to an undefined
      * behavior.
      *
-     * This function does nothing if `data` is `nullptr` or if the
-     * texture was not previously created.
+     * This function does nothing if `data` is `nullptr`, if the
+     * texture was not previously created or if it is compressed.
      *
      * @param data An array of pixels to copy to the texture
      */
@@ -227,14 +279,58 @@ inline namespace v1 {
      * array or the bounds of the area to update, passing invalid
      * arguments will lead to an undefined behavior.
      *
-     * This function does nothing if `data` is `nullptr` or if the
-     * texture was not previously created.
+     * This function does nothing if `data` is `nullptr`, if the
+     * texture was not previously created or if it is compressed.
      *
      * @param data An array of pixels to copy to the texture
      * @param rect The region of the texture to update
      */
     void update(const uint8_t *data, const RectU& rect);
 
+    /**
+     * @brief Enable or disable streaming
+     *
+     * A streaming texture is updated entirely very often (for example,
+     * every frame for a video). In this mode, each full update is made in
+     * a different texture of a small ring of textures, so that the upload
+     * does not have to wait for the draw calls that still use the previous
+     * image. The name of the texture (see getName()) changes after each
+     * full update. The partial updates are made in the current texture.
+     *
+     * A streaming texture must not be the target of a render texture.
+     *
+     * Streaming is disabled by default.
+     *
+     * @param streaming True to enable streaming
+     *
+     * @sa isStreaming()
+     */
+    void setStreaming(bool streaming = true);
+
+    /**
+     * @brief Tell whether streaming is enabled
+     *
+     * @return True if streaming is enabled
+     *
+     * @sa setStreaming()
+     */
+    bool isStreaming() const noexcept {
+      return m_streaming;
+    }
+
+    /**
+     * @brief Check if the last upload is complete
+     *
+     * The pixels are always copied from the client memory before the end
+     * of `create()` or `update()`, but the GPU completes the upload later.
+     * This function checks, without waiting, if the GPU has completed the
+     * last upload. It needs the `GL_APPLE_sync` extension, otherwise the
+     * upload is always considered complete.
+     *
+     * @return True if the last upload is complete
+     */
+    bool isUploadComplete();
+
     /**
      * @brief Compute normalized texture coordinates
      *
@@ -265,12 +361,37 @@ inline namespace v1 {
      */
     bool create(Vector2u size, const uint8_t *data);
 
+    /**
+     * @brief Create the texture from a compressed container
+     *
+     * The container is a KTX or DDS file in memory. If the format is not
+     * supported by the GPU, the first level is decoded and uploaded
+     * uncompressed. If this function fails, the texture is left unchanged.
+     *
+     * @param data Pointer to the file data in memory
+     * @param length Length of the data, in bytes
+     *
+     * @return True if creation was successful
+     */
+    bool createFromCompressed(const uint8_t *data, std::size_t length);
+
+  private:
+    void invalidateMipmap();
+    void releaseStreamNames();
+    void releaseUploadFence();
+    void setUploadFence();
+
   private:
     Format m_format;
     unsigned m_name;
     Vector2u m_size;
     bool m_smooth;
     bool m_repeated;
+    bool m_mipmap;
+    bool m_compressed;
+    bool m_streaming;
+    std::vector<unsigned> m_streamNames; // previous textures of the ring, oldest first
+    void *m_uploadFence;
   };
 
 
@@ -286,6 +407,12 @@ inline namespace v1 {
    * gf::Image, do whatever you need with the pixels, and then call
    * Texture::loadFromImage.
    *
+   * A texture can also be loaded from a KTX or DDS file that contains
+   * pre-compressed data (ETC1, ETC2, S3TC/DXT or ASTC). If the GPU supports
+   * the format, the data and its mipmap levels are uploaded as is, which
+   * saves memory and loading time. Otherwise, the ETC and S3TC formats are
+   * decoded on the CPU and the texture is uncompressed.
+   *
    * Like gf::Image, gf::Texture can handle a unique internal
    * representation of pixels, which is RGBA. This means
    * that a pixel must be composed of 8 bits red, green, blue and
@@ -358,6 +485,9 @@ inline namespace v1 {
      * texture.loadFromImage(image);
      * ~~~
      *
+     * Files with the `.ktx` or `.dds` extension are loaded as compressed
+     * textures.
+     *
      * If this function fails, the texture is left unchanged.
      *
      * @param filename Path of the image file to load
@@ -379,6 +509,9 @@ inline namespace v1 {
      * texture.loadFromImage(image);
      * ~~~
      *
+     * Compressed textures in a KTX or DDS container are recognized and
+     * loaded as such.
+     *
      * If this function fails, the texture is left unchanged.
      *
      * @param stream Source stream to read from
@@ -399,6 +532,9 @@ inline namespace v1 {
      * texture.loadFromImage(image);
      * ~~~
      *
+     * Compressed textures in a KTX or DDS container are recognized and
+     * loaded as such.
+     *
      * If this function fails, the texture is left unchanged.
      *
      * @param data Pointer to the file data in memory
@@ -409,6 +545,8 @@ inline namespace v1 {
      */
     bool loadFromMemory(const uint8_t *data, std::size_t length);
 
+    using BareTexture::update;
+
     /**
      * @brief Update the texture from an image
      *
@@ -21,6 +21,8 @@
 #ifndef GF_TEXTURE_ATLAS_H
 #define GF_TEXTURE_ATLAS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -58,6 +60,18 @@ inline namespace v1 {
    * thanks to the name of the sub-texture, either in pixels or in texture
    * normalized coordinates.
    *
+   * The description can also be stored in a compact binary file, that is
+   * loaded with a single read and without XML parsing. The binary file is
+   * produced by the `gf_atlas` tool that packs a directory of images
+   * offline, or by saveToBinaryFile(). All the integers are 32-bit
+   * unsigned integers in little endian:
+   *
+   * - the magic `GFAT`, followed by the version of the format (1)
+   * - the number of sub-textures
+   * - the length of the texture path, followed by the path
+   * - for each sub-texture: the length of the name, the name, and then the
+   * x, y, width and height of the rectangle
+   *
    * @sa gf::Texture
    * @sa [Texture Atlas (wikipedia)](https://en.wikipedia.org/wiki/Texture_atlas)
    */
@@ -73,15 +87,26 @@ inline namespace v1 {
     }
 
     /**
-     * @brief Load an atlas from a XML file
+     * @brief Load an atlas from a file
      *
-     * Load the data about the sub-textures from a XML file.
+     * Load the data about the sub-textures from a XML file or a binary
+     * file. The format is recognized from the content of the file.
      *
-     * @param filename The filename of the XML file
+     * @param filename The filename of the XML or binary file
      * @return True if the file has been loaded
      */
     bool loadFromFile(const Path& filename);
 
+    /**
+     * @brief Save the atlas to a binary file
+     *
+     * The texture path and the sub-textures are saved.
+     *
+     * @param filename The filename of the binary file
+     * @return True if the file has been saved
+     */
+    bool saveToBinaryFile(const Path& filename) const;
+
     /**
      * @brief Set the texture path
      *
@@ -173,6 +198,10 @@ inline namespace v1 {
      */
     RectF getTextureRect(const std::string& name) const;
 
+  private:
+    bool loadFromXml(const char *data, std::size_t length, const Path& filename);
+    bool loadFromBinary(const uint8_t *data, std::size_t length, const Path& filename);
+
   private:
     Path m_texturePath;
     const Texture *m_texture;
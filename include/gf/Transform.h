@@ -22,6 +22,7 @@
 #define GF_TRANSFORM_H
 
 #include <cmath>
+#include <cstddef>
 
 #include "Matrix.h"
 #include "Portability.h"
@@ -62,6 +63,80 @@ inline namespace v1 {
    */
   GF_API RectF transform(const Matrix3f& mat, const RectF& rect);
 
+  /**
+   * @name Batch transformations
+   *
+   * These functions apply the same computation to many points at once.
+   * They use the SIMD instructions of the processor when available (SSE2,
+   * and AVX for contiguous arrays) and give the same results as the
+   * functions for a single point.
+   *
+   * @{
+   */
+
+  /**
+   * @ingroup core
+   * @brief Apply an affine transformation to an array of 2D points
+   *
+   * `result` can be the same array as `points`. Otherwise, the arrays must
+   * not overlap.
+   *
+   * @param mat The transformation matrix
+   * @param points The points to transform
+   * @param result The transformed points
+   * @param count The number of points
+   */
+  GF_API void transform(const Matrix3f& mat, const Vector2f *points, Vector2f *result, std::size_t count);
+
+  /**
+   * @ingroup core
+   * @brief Apply an affine transformation to 2D points inside structures
+   *
+   * The strides are the distances in bytes between two consecutive points,
+   * e.g. `sizeof(gf::Vertex)` for the positions of an array of vertices.
+   * The input and output can be the same points. Otherwise, they must not
+   * overlap.
+   *
+   * @param mat The transformation matrix
+   * @param points The first point to transform
+   * @param pointsStride The distance between two points to transform
+   * @param result The first transformed point
+   * @param resultStride The distance between two transformed points
+   * @param count The number of points
+   */
+  GF_API void transform(const Matrix3f& mat, const Vector2f *points, std::size_t pointsStride, Vector2f *result, std::size_t resultStride, std::size_t count);
+
+  /**
+   * @ingroup core
+   * @brief Compute the axis-aligned bounding rectangle of 2D points
+   *
+   * @param points The first point
+   * @param count The number of points
+   * @param stride The distance in bytes between two points
+   * @return The smallest rectangle that contains all the points, or an
+   * empty rectangle if there is no point
+   */
+  GF_API RectF computeBounds(const Vector2f *points, std::size_t count, std::size_t stride = sizeof(Vector2f));
+
+  /**
+   * @ingroup core
+   * @brief Compute the corners of transformed rectangles
+   *
+   * Each rectangle @f$ i @f$ starts at the origin, has the size
+   * `sizes[i]` and is transformed by `transforms[i]`. Four points are
+   * written for each rectangle, in the order of gf::PrimitiveType::Quads:
+   * top-left, top-right, bottom-left, bottom-right.
+   *
+   * @param transforms The transformation matrices of the rectangles
+   * @param sizes The sizes of the rectangles
+   * @param result The first corner
+   * @param resultStride The distance in bytes between two corners
+   * @param count The number of rectangles
+   */
+  GF_API void expandQuads(const Matrix3f *transforms, const Vector2f *sizes, Vector2f *result, std::size_t resultStride, std::size_t count);
+
+  /** @} */
+
   /**
    * @ingroup core
    * @brief Get a translation matrix
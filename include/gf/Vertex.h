@@ -24,7 +24,11 @@
 #ifndef GF_VERTEX_H
 #define GF_VERTEX_H
 
+#include <cstddef>
+
 #include "Color.h"
+#include "Id.h"
+#include "Matrix.h"
 #include "Portability.h"
 #include "Vector.h"
 
@@ -33,6 +37,48 @@ namespace gf {
 inline namespace v1 {
 #endif
 
+  /**
+   * @ingroup graphics
+   * @brief The type of the components of a vertex attribute
+   *
+   * @sa gf::VertexAttribute
+   */
+  enum class VertexAttributeType {
+    Float,        ///< 32-bit floating point components
+    UnsignedByte, ///< 8-bit unsigned integer components
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief The description of an attribute in a vertex
+   *
+   * @sa gf::VertexFormat
+   */
+  struct GF_API VertexAttribute {
+    const char *name; ///< Name of the attribute in the shader, e.g. `"a_position"`
+    Id id; ///< Identifier of the name, e.g. `"a_position"_id`
+    int size; ///< Number of components of the attribute
+    VertexAttributeType type; ///< Type of the components
+    bool normalized; ///< Are the integer components mapped to @f$ [0, 1] @f$?
+    std::size_t offset; ///< Offset of the attribute in the vertex
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief The description of the layout of a vertex
+   *
+   * A vertex format tells how the attributes of the shader are laid out in
+   * a vertex. The vertex types of gf give their format with a static
+   * `getFormat()` function.
+   *
+   * @sa gf::Vertex, gf::PackedVertex, gf::BatchVertex
+   */
+  struct GF_API VertexFormat {
+    std::size_t stride; ///< Size of a vertex
+    const VertexAttribute *attributes; ///< Array of attributes
+    std::size_t count; ///< Number of attributes
+  };
+
   /**
    * @ingroup graphics
    * @brief A point associated with a color and a texture coordinate
@@ -70,12 +116,106 @@ inline namespace v1 {
    * renderer.draw(triangle, 3, gf::PrimitiveType::Triangles);
    * ~~~
    *
-   * @sa gf::PrimitiveType, gf::RenderTarget::draw
+   * @sa gf::PrimitiveType, gf::RenderTarget::draw, gf::PackedVertex
    */
   struct GF_API Vertex {
     Vector2f position; ///< Position of the vertex in world coordinates
     Color4f color = Color::White; ///< %Color of the vertex (default: white)
     Vector2f texCoords = Vector2f{ 0.0f, 0.0f }; ///< Coordinates of the texture
+
+    /**
+     * @brief Get the format of the vertex
+     */
+    static const VertexFormat& getFormat();
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief A vertex with a compact color
+   *
+   * gf::PackedVertex is the same as gf::Vertex except that its color has
+   * 8-bit components. It takes 20 bytes instead of 32 bytes so that there is
+   * less data to send to the graphics memory. It can be used everywhere the
+   * colors do not need more precision, which is the common case.
+   *
+   * ~~~{.cc}
+   * gf::PackedVertex vertex;
+   * vertex.position = { 0.0f, 0.5f };
+   * vertex.color = gf::Color::toRgba32(gf::Color::Red);
+   * ~~~
+   *
+   * @sa gf::Vertex, gf::Color::toRgba32
+   */
+  struct GF_API PackedVertex {
+    Vector2f position; ///< Position of the vertex in world coordinates
+    Color4u color = Color4u{ 0xFF, 0xFF, 0xFF, 0xFF }; ///< %Color of the vertex (default: white)
+    Vector2f texCoords = Vector2f{ 0.0f, 0.0f }; ///< Coordinates of the texture
+
+    /**
+     * @brief Get the format of the vertex
+     */
+    static const VertexFormat& getFormat();
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief A vertex associated with a texture slot
+   *
+   * gf::BatchVertex is a gf::Vertex that also indicates which texture must be
+   * used for the vertex, among the textures given to the draw call. It makes
+   * it possible to draw primitives with different textures in a single draw
+   * call.
+   *
+   * The texture slot must be the same for all the vertices of a primitive.
+   *
+   * @sa gf::RenderTarget::draw, gf::SpriteBatch
+   */
+  struct GF_API BatchVertex {
+    Vector2f position; ///< Position of the vertex in world coordinates
+    Color4u color = Color4u{ 0xFF, 0xFF, 0xFF, 0xFF }; ///< %Color of the vertex (default: white)
+    Vector2f texCoords = Vector2f{ 0.0f, 0.0f }; ///< Coordinates of the texture
+    float textureSlot = 0.0f; ///< Index of the texture in the textures of the draw call
+
+    /**
+     * @brief Get the format of the vertex
+     */
+    static const VertexFormat& getFormat();
+  };
+
+  /**
+   * @ingroup graphics
+   * @brief The data of an instance for an instanced draw
+   *
+   * When the same geometry is drawn many times, each copy is an instance
+   * with its own transformation and color. The color of the instance
+   * multiplies the color of the vertices.
+   *
+   * Only the affine part of the transformation is used, i.e. the last row
+   * of the matrix is ignored.
+   *
+   * ~~~{.cc}
+   * std::vector<gf::InstanceData> instances(100);
+   *
+   * for (std::size_t i = 0; i < instances.size(); ++i) {
+   *   instances[i].transform = gf::translation({ i * 32.0f, 0.0f });
+   * }
+   *
+   * renderer.drawInstanced(buffer, instances.data(), instances.size());
+   * ~~~
+   *
+   * @sa gf::RenderTarget::drawInstanced
+   */
+  struct GF_API InstanceData {
+    Matrix3f transform = identity<Matrix3f>(); ///< Transformation of the instance
+    Color4f color = Color::White; ///< %Color of the instance (default: white)
+
+    /**
+     * @brief Get the format of the instance data
+     *
+     * The transformation is given to the shader in two attributes for the
+     * first two rows of the matrix.
+     */
+    static const VertexFormat& getFormat();
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
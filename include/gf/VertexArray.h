@@ -42,8 +42,10 @@ inline namespace v1 {
    * @ingroup graphics
    * @brief A set of primitives
    *
-   * gf::VertexArray is a very simple wrapper around a dynamic
-   * array of vertices and a primitive type.
+   * gf::BasicVertexArray is a very simple wrapper around a dynamic
+   * array of vertices and a primitive type. It is usually used through
+   * gf::VertexArray (with gf::Vertex) or gf::PackedVertexArray (with
+   * gf::PackedVertex).
    *
    * It inherits gf::Drawable, but unlike other drawables it
    * is not transformable.
@@ -60,9 +62,10 @@ inline namespace v1 {
    * window.draw(lines);
    * ~~~
    *
-   * @sa gf::Vertex
+   * @sa gf::Vertex, gf::PackedVertex
    */
-  class GF_API VertexArray : public Drawable {
+  template<typename VertexType>
+  class BasicVertexArray : public Drawable {
   public:
     /**
      * @brief Default constructor
@@ -70,7 +73,7 @@ inline namespace v1 {
      * Creates an empty vertex array. The default primitive type is
      * gf::PrimitiveType::Points.
      */
-    VertexArray()
+    BasicVertexArray()
     : m_type(PrimitiveType::Points)
     {
 
@@ -83,7 +86,7 @@ inline namespace v1 {
      * @param type Type of primitives
      * @param count Initial number of vertices in the array
      */
-    VertexArray(PrimitiveType type, std::size_t count = 0)
+    BasicVertexArray(PrimitiveType type, std::size_t count = 0)
     : m_type(type)
     , m_vertices(count)
     {
@@ -104,7 +107,7 @@ inline namespace v1 {
      *
      * @return A pointer to the vertices in the array
      */
-    const Vertex *getVertexData() const {
+    const VertexType *getVertexData() const {
       return m_vertices.data();
     }
 
@@ -121,7 +124,7 @@ inline namespace v1 {
      *
      * @sa getVertexCount()
      */
-    Vertex& operator[](std::size_t index) {
+    VertexType& operator[](std::size_t index) {
       return m_vertices[index];
     }
 
@@ -138,7 +141,7 @@ inline namespace v1 {
      *
      * @sa getVertexCount()
      */
-    const Vertex& operator[](std::size_t index) const {
+    const VertexType& operator[](std::size_t index) const {
       return m_vertices[index];
     }
 
@@ -193,7 +196,7 @@ inline namespace v1 {
      *
      * @param vertex The vertex to add
      */
-    void append(const Vertex& vertex) {
+    void append(const VertexType& vertex) {
       m_vertices.push_back(vertex);
     }
 
@@ -238,9 +241,27 @@ inline namespace v1 {
 
   private:
     PrimitiveType m_type;
-    std::vector<Vertex> m_vertices;
+    std::vector<VertexType> m_vertices;
   };
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  extern template class GF_API BasicVertexArray<Vertex>;
+  extern template class GF_API BasicVertexArray<PackedVertex>;
+#endif
+
+  /**
+   * @ingroup graphics
+   * @brief A set of primitives with gf::Vertex
+   */
+  typedef BasicVertexArray<Vertex> VertexArray;
+
+  /**
+   * @ingroup graphics
+   * @brief A set of primitives with gf::PackedVertex
+   */
+  typedef BasicVertexArray<PackedVertex> PackedVertexArray;
+
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 }
 #endif
@@ -23,6 +23,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "Portability.h"
 #include "PrimitiveType.h"
@@ -33,6 +34,8 @@ inline namespace v1 {
 #endif
 
   struct Vertex;
+  struct PackedVertex;
+  struct VertexFormat;
 
   /**
    * @ingroup graphics
@@ -40,13 +43,22 @@ inline namespace v1 {
    *
    * A vertex buffer is a buffer that resides directly in the graphics memory.
    * The advantage is that the draw operations are faster than uploading data
-   * each time. The drawback is that the data must not change, i.e. data can
-   * be loaded only once.
+   * each time.
+   *
+   * The data can be changed after the first load, with `load()` again,
+   * `update()` or `updateRange()`. The storage in the graphics memory is
+   * reused when it is large enough, and grows geometrically otherwise. The
+   * usage hint tells the driver how often the data changes (see
+   * gf::VertexBuffer::Usage).
    *
    * In gf, a vertex buffer can be used directly. But the main usage is for
    * drawable entities that can upload the final geometry and give the
    * corresponding vertex buffer.
    *
+   * If the context does not support instanced drawing, a vertex buffer keeps
+   * a copy of its data in the client memory, so that
+   * gf::RenderTarget::drawInstanced() can expand the instances.
+   *
    * Usage:
    *
    * ~~~{.cc}
@@ -69,11 +81,29 @@ inline namespace v1 {
    */
   class GF_API VertexBuffer {
   public:
+    /**
+     * @brief A hint about the changes of the data
+     */
+    enum class Usage {
+      Static,   ///< The data is loaded once and drawn many times (default)
+      Dynamic,  ///< The data is changed from time to time and drawn many times
+      Stream,   ///< The data is changed nearly every time it is drawn
+    };
+
     /**
      * @brief Default constructor
+     *
+     * The usage hint is gf::VertexBuffer::Usage::Static.
      */
     VertexBuffer();
 
+    /**
+     * @brief Constructor with a usage hint
+     *
+     * @param usage The usage hint of the buffer
+     */
+    explicit VertexBuffer(Usage usage);
+
     /**
      * @brief Destructor.
      */
@@ -99,9 +129,35 @@ inline namespace v1 {
      */
     VertexBuffer& operator=(VertexBuffer&& other);
 
+    /**
+     * @brief Set the usage hint of the buffer
+     *
+     * The hint is given to the driver when the storage is allocated, i.e.
+     * at the first load or when the storage grows.
+     *
+     * @param usage The usage hint of the buffer
+     * @sa getUsage()
+     */
+    void setUsage(Usage usage) {
+      m_usage = usage;
+    }
+
+    /**
+     * @brief Get the usage hint of the buffer
+     *
+     * @return The usage hint of the buffer
+     * @sa setUsage()
+     */
+    Usage getUsage() const {
+      return m_usage;
+    }
+
     /**
      * @brief Load an array of vertices
      *
+     * If the buffer already has data, the data is replaced. If the array
+     * is empty, the buffer draws nothing until the next load.
+     *
      * @param vertices Pointer to the vertices
      * @param count Number of vertices in the array
      * @param type Type of primitives to draw
@@ -118,6 +174,102 @@ inline namespace v1 {
      */
     void load(const Vertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type);
 
+    /**
+     * @brief Load an array of packed vertices
+     *
+     * @param vertices Pointer to the vertices
+     * @param count Number of vertices in the array
+     * @param type Type of primitives to draw
+     */
+    void load(const PackedVertex *vertices, std::size_t count, PrimitiveType type);
+
+    /**
+     * @brief Load an array of packed vertices and their indices
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     */
+    void load(const PackedVertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type);
+
+    /**
+     * @brief Load an array of vertices and their 32-bit indices
+     *
+     * If the indices fit in 16 bits, they are stored as 16-bit indices.
+     * Otherwise, they are stored as 32-bit indices if the context supports
+     * them (`GL_OES_element_index_uint`). If it does not, the geometry is
+     * converted to a list of primitives and split in as few parts as
+     * possible with 16-bit indices, each part is drawn with its own draw
+     * call.
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     */
+    void load(const Vertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type);
+
+    /**
+     * @brief Load an array of packed vertices and their 32-bit indices
+     *
+     * See the previous function for the storage of the indices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param indices Pointer to the indices
+     * @param count Number of indices in the array
+     * @param type Type of primitives to draw
+     */
+    void load(const PackedVertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type);
+
+    /**
+     * @brief Replace the vertices of the buffer
+     *
+     * The primitive type and the indices (if any) are kept. If the buffer
+     * has indices, the vertices must contain all the indexed vertices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param count Number of vertices in the array
+     */
+    void update(const Vertex *vertices, std::size_t count);
+
+    /**
+     * @brief Replace the packed vertices of the buffer
+     *
+     * The primitive type and the indices (if any) are kept. If the buffer
+     * has indices, the vertices must contain all the indexed vertices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param count Number of vertices in the array
+     */
+    void update(const PackedVertex *vertices, std::size_t count);
+
+    /**
+     * @brief Replace a range of vertices in the buffer
+     *
+     * The vertices must have the same format as the vertices of the buffer
+     * and the range must be inside the current vertices. This function is
+     * not available for a buffer that has been split (see
+     * load(const Vertex *, const uint32_t *, std::size_t, PrimitiveType)).
+     *
+     * @param vertices Pointer to the vertices
+     * @param first Index of the first vertex to replace
+     * @param count Number of vertices in the array
+     */
+    void updateRange(const Vertex *vertices, std::size_t first, std::size_t count);
+
+    /**
+     * @brief Replace a range of packed vertices in the buffer
+     *
+     * The vertices must have the same format as the vertices of the buffer
+     * and the range must be inside the current vertices.
+     *
+     * @param vertices Pointer to the vertices
+     * @param first Index of the first vertex to replace
+     * @param count Number of vertices in the array
+     */
+    void updateRange(const PackedVertex *vertices, std::size_t first, std::size_t count);
+
     /**
      * @brief Check if there is an array buffer
      *
@@ -149,6 +301,22 @@ inline namespace v1 {
       return m_count;
     }
 
+    /**
+     * @brief Get the number of vertices in the buffer
+     *
+     * @return The number of vertices
+     */
+    std::size_t getVertexCount() const {
+      return m_vertexCount;
+    }
+
+    /**
+     * @brief Get the number of vertices the buffer can hold without growing
+     *
+     * @return The capacity of the buffer, in vertices
+     */
+    std::size_t getVertexCapacity() const;
+
     /**
      * @brief Get the primitive type of the data in the buffer
      *
@@ -162,6 +330,19 @@ inline namespace v1 {
       return m_type;
     }
 
+    /**
+     * @brief Get the format of the vertices in the buffer
+     *
+     * This function returns the format of the vertices given in
+     * VertexBuffer::load().
+     *
+     * @return The format of the vertices
+     * @sa load()
+     */
+    const VertexFormat& getFormat() const {
+      return *m_format;
+    }
+
     /**
      * @brief Binds a vertex buffer
      *
@@ -171,11 +352,44 @@ inline namespace v1 {
      */
     static void bind(const VertexBuffer *buffer);
 
+  private:
+    friend class RenderTarget;
+
+    void loadVertices(const void *vertices, std::size_t count, const VertexFormat& format, PrimitiveType type);
+    void loadVertices(const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type);
+    void loadVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type);
+    void loadSplitVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type);
+    void updateVertices(const void *vertices, std::size_t count, const VertexFormat& format);
+    void updateVertexRange(const void *vertices, std::size_t first, std::size_t count, const VertexFormat& format);
+    bool uploadVertices(const void *vertices, std::size_t count, const VertexFormat& format);
+    bool uploadIndices(const void *indices, std::size_t count, std::size_t indexSize);
+    void releaseIndices();
+
+    struct IndexChunk {
+      std::size_t vertexOffset; // in vertices
+      std::size_t indexOffset; // in indices
+      std::size_t indexCount;
+    };
+
   private:
     unsigned m_vbo;
     unsigned m_ebo;
     std::size_t m_count;
     PrimitiveType m_type;
+    const VertexFormat *m_format;
+    Usage m_usage;
+    std::size_t m_vertexCount;
+    std::size_t m_vboCapacity; // in bytes
+    std::size_t m_eboCapacity; // in bytes
+    bool m_largeIndices; // 32-bit indices
+
+    // only for split buffers
+    std::vector<IndexChunk> m_chunks;
+    std::vector<uint32_t> m_splitVertices; // original index of the vertices
+
+    // only without instanced arrays, the indices are in the whole array
+    std::vector<uint8_t> m_clientVertices;
+    std::vector<uint32_t> m_clientIndices;
   };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
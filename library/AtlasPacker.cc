@@ -0,0 +1,270 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/AtlasPacker.h>
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+
+#include <gf/Image.h>
+#include <gf/Log.h>
+#include <gf/Texture.h>
+#include <gf/TextureAtlas.h>
+
+namespace gf {
+inline namespace v1 {
+
+  /*
+   * RectanglePacker
+   */
+
+  RectanglePacker::RectanglePacker(Vector2u size, bool allowRotation)
+  : m_size(size)
+  , m_allowRotation(allowRotation)
+  , m_usedArea(0)
+  {
+    m_freeRectangles.push_back(RectU({ 0, 0 }, size));
+  }
+
+  namespace {
+
+    struct Fit {
+      unsigned shortSide = std::numeric_limits<unsigned>::max();
+      unsigned longSide = std::numeric_limits<unsigned>::max();
+
+      bool isBetterThan(const Fit& other) const {
+        return shortSide < other.shortSide || (shortSide == other.shortSide && longSide < other.longSide);
+      }
+    };
+
+    Fit computeFit(const RectU& freeRectangle, Vector2u size) {
+      Fit fit;
+
+      if (size.width <= freeRectangle.width && size.height <= freeRectangle.height) {
+        unsigned leftoverWidth = freeRectangle.width - size.width;
+        unsigned leftoverHeight = freeRectangle.height - size.height;
+        fit.shortSide = std::min(leftoverWidth, leftoverHeight);
+        fit.longSide = std::max(leftoverWidth, leftoverHeight);
+      }
+
+      return fit;
+    }
+
+  }
+
+  bool RectanglePacker::insert(Vector2u size, RectU& rect) {
+    if (size.width == 0 || size.height == 0) {
+      return false;
+    }
+
+    Fit best;
+    RectU placement;
+
+    for (auto& freeRectangle : m_freeRectangles) {
+      Fit fit = computeFit(freeRectangle, size);
+
+      if (fit.isBetterThan(best)) {
+        best = fit;
+        placement = RectU(freeRectangle.position, size);
+      }
+
+      if (m_allowRotation && size.width != size.height) {
+        Vector2u rotated(size.height, size.width);
+        fit = computeFit(freeRectangle, rotated);
+
+        if (fit.isBetterThan(best)) {
+          best = fit;
+          placement = RectU(freeRectangle.position, rotated);
+        }
+      }
+    }
+
+    if (placement.width == 0) {
+      return false;
+    }
+
+    splitFreeRectangles(placement);
+    pruneFreeRectangles();
+
+    m_usedArea += static_cast<uint64_t>(placement.width) * placement.height;
+    rect = placement;
+    return true;
+  }
+
+  float RectanglePacker::getOccupancy() const {
+    return static_cast<float>(m_usedArea) / (static_cast<float>(m_size.width) * m_size.height);
+  }
+
+  void RectanglePacker::splitFreeRectangles(const RectU& used) {
+    std::vector<RectU> splitted;
+
+    auto it = std::remove_if(m_freeRectangles.begin(), m_freeRectangles.end(), [&used, &splitted](const RectU& free) {
+      if (!free.intersects(used)) {
+        return false;
+      }
+
+      // keep the maximal rectangles around the used rectangle
+      unsigned freeRight = free.left + free.width;
+      unsigned freeBottom = free.top + free.height;
+      unsigned usedRight = used.left + used.width;
+      unsigned usedBottom = used.top + used.height;
+
+      if (used.left > free.left) {
+        splitted.push_back(RectU(free.left, free.top, used.left - free.left, free.height));
+      }
+
+      if (usedRight < freeRight) {
+        splitted.push_back(RectU(usedRight, free.top, freeRight - usedRight, free.height));
+      }
+
+      if (used.top > free.top) {
+        splitted.push_back(RectU(free.left, free.top, free.width, used.top - free.top));
+      }
+
+      if (usedBottom < freeBottom) {
+        splitted.push_back(RectU(free.left, usedBottom, free.width, freeBottom - usedBottom));
+      }
+
+      return true;
+    });
+
+    m_freeRectangles.erase(it, m_freeRectangles.end());
+    m_freeRectangles.insert(m_freeRectangles.end(), splitted.begin(), splitted.end());
+  }
+
+  void RectanglePacker::pruneFreeRectangles() {
+    // remove the free rectangles that are contained in another one
+    for (std::size_t i = 0; i < m_freeRectangles.size(); ++i) {
+      for (std::size_t j = i + 1; j < m_freeRectangles.size(); ++j) {
+        if (m_freeRectangles[j].contains(m_freeRectangles[i])) {
+          m_freeRectangles.erase(m_freeRectangles.begin() + i);
+          --i;
+          break;
+        }
+
+        if (m_freeRectangles[i].contains(m_freeRectangles[j])) {
+          m_freeRectangles.erase(m_freeRectangles.begin() + j);
+          --j;
+        }
+      }
+    }
+  }
+
+  /*
+   * AtlasPacker
+   */
+
+  struct AtlasPacker::Page {
+    Page(Vector2u size)
+    : packer(size)
+    {
+
+    }
+
+    RectanglePacker packer;
+    Texture texture;
+    TextureAtlas atlas;
+  };
+
+  AtlasPacker::AtlasPacker(Vector2u pageSize, unsigned padding)
+  : m_pageSize(pageSize)
+  , m_padding(padding)
+  {
+
+  }
+
+  AtlasPacker::~AtlasPacker() = default;
+
+  const TextureAtlas *AtlasPacker::addImage(const std::string& name, const Image& image) {
+    auto it = m_names.find(name);
+
+    if (it != m_names.end()) {
+      return &m_pages[it->second]->atlas;
+    }
+
+    Vector2u size = image.getSize();
+
+    if (size.width > m_pageSize.width || size.height > m_pageSize.height) {
+      Log::warning(Log::Resources, "Image '%s' is too big for the atlas: %ux%u\n", name.c_str(), size.width, size.height);
+      return nullptr;
+    }
+
+    // the padding is on the right and bottom sides, the bins are enlarged to
+    // let the images touch the right and bottom sides of the pages
+    Vector2u paddedSize(size.width + m_padding, size.height + m_padding);
+
+    std::size_t index = 0;
+    RectU rect;
+
+    while (index < m_pages.size() && !m_pages[index]->packer.insert(paddedSize, rect)) {
+      ++index;
+    }
+
+    if (index == m_pages.size()) {
+      Page& page = addPage();
+      bool inserted = page.packer.insert(paddedSize, rect);
+      assert(inserted);
+      (void) inserted;
+    }
+
+    Page& page = *m_pages[index];
+    rect.size = size;
+    page.texture.update(image.getPixelsPtr(), rect);
+    page.atlas.addSubTexture(name, rect);
+    m_names.emplace(name, index);
+    return &page.atlas;
+  }
+
+  const TextureAtlas *AtlasPacker::findAtlas(const std::string& name) const {
+    auto it = m_names.find(name);
+
+    if (it == m_names.end()) {
+      return nullptr;
+    }
+
+    return &m_pages[it->second]->atlas;
+  }
+
+  Texture& AtlasPacker::getTexture(std::size_t page) {
+    assert(page < m_pages.size());
+    return m_pages[page]->texture;
+  }
+
+  const TextureAtlas& AtlasPacker::getAtlas(std::size_t page) const {
+    assert(page < m_pages.size());
+    return m_pages[page]->atlas;
+  }
+
+  AtlasPacker::Page& AtlasPacker::addPage() {
+    std::unique_ptr<Page> page(new Page(m_pageSize + m_padding));
+
+    // start with transparent pixels, so that nothing bleeds in the padding
+    Image image;
+    image.create(m_pageSize, Color4u{ 0x00, 0x00, 0x00, 0x00 });
+    page->texture.loadFromImage(image);
+    page->atlas.setTexture(page->texture);
+
+    m_pages.push_back(std::move(page));
+    return *m_pages.back();
+  }
+
+}
+}
@@ -0,0 +1,144 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/BlurEffects.h>
+
+#include <algorithm>
+
+#include <gf/Texture.h>
+
+#include "config.h"
+
+namespace gf {
+inline namespace v1 {
+
+  static Vector2u getDownsampledSize(Vector2u size, unsigned factor) {
+    return { std::max(size.width / factor, 1u), std::max(size.height / factor, 1u) };
+  }
+
+  BlurEffect::BlurEffect()
+  : m_downsampling(Downsampling::Half)
+  , m_iterations(1)
+  {
+    Path vertexShaderPath = Path(GF_DATADIR) / "shaders/default.vert";
+    Path fragmentShaderPath = Path(GF_DATADIR) / "shaders/default.frag";
+    m_copy.loadFromFile(vertexShaderPath, fragmentShaderPath);
+
+    Path blurVertexShaderPath = Path(GF_DATADIR) / "shaders/blur.vert";
+    Path blurFragmentShaderPath = Path(GF_DATADIR) / "shaders/blur.frag";
+    m_blur.loadFromFile(blurVertexShaderPath, blurFragmentShaderPath);
+  }
+
+  void BlurEffect::apply(RenderPipeline& pipeline, const Texture& source, const RenderTargetPool::Target *target) {
+    RenderTargetPool::Target *blurred = blur(pipeline, source, m_copy);
+
+    if (blurred == nullptr) {
+      pipeline.drawPass(m_copy, source, target);
+      return;
+    }
+
+    pipeline.drawPass(m_copy, blurred->getTexture(), target);
+    pipeline.getTargetPool().release(blurred);
+  }
+
+  RenderTargetPool::Target *BlurEffect::blur(RenderPipeline& pipeline, const Texture& source, Effect& filter) {
+    RenderTargetPool& pool = pipeline.getTargetPool();
+
+    // the bilinear filtering averages 2x2 texels in each downsample pass
+
+    Vector2u halfSize = getDownsampledSize(source.getSize(), 2);
+    RenderTargetPool::Target *current = pool.acquire(halfSize);
+
+    if (current == nullptr) {
+      return nullptr;
+    }
+
+    pipeline.drawPass(filter, source, current);
+
+    if (m_downsampling == Downsampling::Quarter) {
+      RenderTargetPool::Target *quarter = pool.acquire(getDownsampledSize(source.getSize(), 4));
+
+      if (quarter == nullptr) {
+        pool.release(current);
+        return nullptr;
+      }
+
+      pipeline.drawPass(m_copy, current->getTexture(), quarter);
+      pool.release(current);
+      current = quarter;
+    }
+
+    Vector2u size = current->getSize();
+    RenderTargetPool::Target *other = pool.acquire(size);
+
+    if (other == nullptr) {
+      pool.release(current);
+      return nullptr;
+    }
+
+    Vector2f horizontal(1.0f / size.width, 0.0f);
+    Vector2f vertical(0.0f, 1.0f / size.height);
+
+    for (unsigned i = 0; i < m_iterations; ++i) {
+      m_blur.setUniform("u_step", horizontal);
+      pipeline.drawPass(m_blur, current->getTexture(), other);
+      m_blur.setUniform("u_step", vertical);
+      pipeline.drawPass(m_blur, other->getTexture(), current);
+    }
+
+    pool.release(other);
+    return current;
+  }
+
+
+  BloomEffect::BloomEffect() {
+    Path vertexShaderPath = Path(GF_DATADIR) / "shaders/default.vert";
+    Path thresholdShaderPath = Path(GF_DATADIR) / "shaders/bloom_threshold.frag";
+    m_threshold.loadFromFile(vertexShaderPath, thresholdShaderPath);
+    m_threshold.setUniform("u_threshold", 0.7f);
+
+    Path combineShaderPath = Path(GF_DATADIR) / "shaders/bloom.frag";
+    m_combine.loadFromFile(vertexShaderPath, combineShaderPath);
+    m_combine.setUniform("u_intensity", 1.0f);
+  }
+
+  void BloomEffect::setThreshold(float threshold) {
+    m_threshold.setUniform("u_threshold", threshold);
+  }
+
+  void BloomEffect::setIntensity(float intensity) {
+    m_combine.setUniform("u_intensity", intensity);
+  }
+
+  void BloomEffect::apply(RenderPipeline& pipeline, const Texture& source, const RenderTargetPool::Target *target) {
+    RenderTargetPool::Target *blurred = blur(pipeline, source, m_threshold);
+
+    if (blurred == nullptr) {
+      pipeline.drawPass(getCopyEffect(), source, target);
+      return;
+    }
+
+    m_combine.setUniform("u_bloomTexture", blurred->getTexture());
+    pipeline.drawPass(m_combine, source, target);
+    pipeline.getTargetPool().release(blurred);
+  }
+
+}
+}
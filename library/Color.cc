@@ -157,5 +157,25 @@ inline namespace v1 {
     return convertHsvToRgb(hsv);
   }
 
+  Color4u Color::toRgba32(Color4f color) {
+    Color4u result;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+      result[i] = static_cast<uint8_t>(clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    return result;
+  }
+
+  Color4f Color::fromRgba32(Color4u color) {
+    Color4f result;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+      result[i] = color[i] / 255.0f;
+    }
+
+    return result;
+  }
+
 }
 }
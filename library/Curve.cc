@@ -90,16 +90,24 @@ inline namespace v1 {
 
   VertexBuffer Curve::commitGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+    commitGeometry(buffer);
     return buffer;
   }
 
+  void Curve::commitGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+  }
+
   VertexBuffer Curve::commitOutlineGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+    commitOutlineGeometry(buffer);
     return buffer;
   }
 
+  void Curve::commitOutlineGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+  }
+
   void Curve::draw(RenderTarget& target, RenderStates states) {
     states.transform *= getTransform();
 
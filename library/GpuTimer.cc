@@ -0,0 +1,137 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/GpuTimer.h>
+
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "priv/Debug.h"
+
+namespace gf {
+inline namespace v1 {
+
+  /*
+   * The queries form a ring: the pending queries are the m_pending queries
+   * after m_first. A new measure uses the query after the pending ones,
+   * and the pending queries are read in order when their results are
+   * available.
+   */
+
+  constexpr std::size_t GpuTimer::QueryCount;
+
+  GpuTimer::GpuTimer()
+  : m_first(0)
+  , m_pending(0)
+  , m_running(false)
+  , m_hasResult(false)
+  {
+    std::fill(std::begin(m_queries), std::end(m_queries), 0);
+
+    if (isAvailable()) {
+      GLuint names[QueryCount];
+      glCheck(glGenQueriesEXT(QueryCount, names));
+      std::copy(std::begin(names), std::end(names), std::begin(m_queries));
+    }
+  }
+
+  GpuTimer::~GpuTimer() {
+    if (isAvailable() && m_queries[0] != 0) {
+      GLuint names[QueryCount];
+      std::copy(std::begin(m_queries), std::end(m_queries), std::begin(names));
+      glCheck(glDeleteQueriesEXT(QueryCount, names));
+    }
+  }
+
+  bool GpuTimer::isAvailable() {
+    return GLAD_GL_EXT_disjoint_timer_query != 0;
+  }
+
+  void GpuTimer::begin() {
+    if (!isAvailable() || m_running) {
+      return;
+    }
+
+    poll();
+
+    if (m_pending == QueryCount) {
+      // the GPU is late, skip this measure rather than wait
+      return;
+    }
+
+    std::size_t index = (m_first + m_pending) % QueryCount;
+    glCheck(glBeginQueryEXT(GL_TIME_ELAPSED_EXT, m_queries[index]));
+    m_running = true;
+  }
+
+  void GpuTimer::end() {
+    if (!m_running) {
+      return;
+    }
+
+    glCheck(glEndQueryEXT(GL_TIME_ELAPSED_EXT));
+    m_running = false;
+    ++m_pending;
+  }
+
+  bool GpuTimer::hasResult() {
+    poll();
+    return m_hasResult;
+  }
+
+  Time GpuTimer::getElapsedTime() {
+    poll();
+    return m_elapsed;
+  }
+
+  void GpuTimer::poll() {
+    if (m_pending == 0) {
+      return;
+    }
+
+    // a disjoint event invalidates all the measures in flight
+    GLint disjoint = GL_FALSE;
+    glCheck(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+
+    while (m_pending > 0) {
+      GLuint query = m_queries[m_first];
+
+      GLuint available = GL_FALSE;
+      glCheck(glGetQueryObjectuivEXT(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available));
+
+      if (available == GL_FALSE && disjoint == GL_FALSE) {
+        break;
+      }
+
+      if (disjoint == GL_FALSE) {
+        GLuint64 elapsed = 0;
+        glCheck(glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT_EXT, &elapsed));
+        m_elapsed = microseconds(static_cast<int64_t>(elapsed / 1000));
+        m_hasResult = true;
+      }
+
+      m_first = (m_first + 1) % QueryCount;
+      --m_pending;
+    }
+  }
+
+}
+}
@@ -24,121 +24,201 @@
 
 #include <glad/glad.h>
 
-#include <gf/PostProcessing.h>
+#include <gf/Effect.h>
 #include <gf/Window.h>
 
 #include "priv/Debug.h"
+#include "priv/RenderCounters.h"
 #include "priv/Utils.h"
 
 namespace gf {
 inline namespace v1 {
 
+  static void bindFramebuffer(unsigned name) {
+    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(name)));
+    ++priv::getRenderCounters().framebufferSwitches;
+  }
+
+  MultiPassEffect::~MultiPassEffect() = default;
+
   RenderPipeline::RenderPipeline(Window& window)
   : m_window(window)
+  , m_buffers{ nullptr, nullptr }
   , m_current(0)
+  , m_bufferSize(window.getFramebufferSize())
+  , m_inPass(false)
+  , m_passSize(0, 0)
+  , m_resizePending(false)
+  , m_resizeDelay(milliseconds(100))
   {
     initialize();
-    Texture::bind(nullptr);
+    bindFrameTarget();
+  }
 
-    Vector2u size = m_window.getFramebufferSize();
+  RenderPipeline::~RenderPipeline() {
+    releaseBuffers();
+  }
 
-    for (auto& buffer : m_buffers) {
-      buffer.name = 0;
+  void RenderPipeline::addEffect(Effect& effect) {
+    m_effects.push_back({ &effect, nullptr });
+    bindFrameTarget();
+  }
 
-      if (!buffer.texture.create(size)) {
-        continue;
-      }
+  void RenderPipeline::addEffect(MultiPassEffect& effect) {
+    m_effects.push_back({ nullptr, &effect });
+    bindFrameTarget();
+  }
 
-      buffer.texture.setSmooth();
+  void RenderPipeline::clearEffects() {
+    m_effects.clear();
+    releaseBuffers();
+    bindFrameTarget();
+  }
 
-      GLuint name;
-      glCheck(glGenFramebuffers(1, &name));
-      buffer.name = static_cast<unsigned>(name);
+  void RenderPipeline::resized() {
+    m_resizePending = (m_window.getFramebufferSize() != m_bufferSize);
+    m_resizeClock.restart();
 
-      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, name));
-      glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer.texture.getName(), 0));
-      assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
-      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    // without effects, there is no buffer to reallocate
+    if (m_resizePending && (m_effects.empty() || m_resizeDelay <= Time())) {
+      applyResize();
     }
-
-    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_buffers[m_current].name));
   }
 
-  RenderPipeline::~RenderPipeline() {
-    for (auto& buffer : m_buffers) {
-      if (buffer.name != 0) {
-        GLuint name = static_cast<GLuint>(buffer.name);
-        glCheck(glDeleteFramebuffers(1, &name));
-      }
+  Vector2u RenderPipeline::getSize() const {
+    if (m_inPass) {
+      return m_passSize;
     }
 
-  }
+    if (m_effects.empty()) {
+      return m_window.getFramebufferSize();
+    }
 
-  void RenderPipeline::addEffect(Effect& effect) {
-    m_effects.push_back(&effect);
+    return m_bufferSize;
   }
 
-  void RenderPipeline::clearEffects() {
-    m_effects.clear();
-  }
+  void RenderPipeline::display() {
+    // the scene must be in the buffer before the effects read it
+    flushRenderQueue();
 
-  void RenderPipeline::resized() {
-    Texture::bind(nullptr);
+    if (m_buffers[m_current] != nullptr) {
+      // process the effects, the last one draws directly to the window
 
-    Vector2u size = m_window.getFramebufferSize();
+      for (std::size_t i = 0; i < m_effects.size(); ++i) {
+        const Texture& source = m_buffers[m_current]->getTexture();
+        const RenderTargetPool::Target *target = nullptr;
 
-    for (auto& buffer : m_buffers) {
-      if (!buffer.texture.create(size)) {
-        continue;
+        if (i + 1 < m_effects.size()) {
+          m_current = 1 - m_current;
+          target = m_buffers[m_current];
+        }
+
+        const Step& step = m_effects[i];
+
+        if (step.effect != nullptr) {
+          drawPass(*step.effect, source, target, BlendAlpha);
+        } else {
+          assert(step.multiPassEffect != nullptr);
+          step.multiPassEffect->apply(*this, source, target);
+        }
       }
+    }
+
+    m_window.display();
 
-      buffer.texture.setSmooth();
+    // prepare for next frame
 
-      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, buffer.name));
-      glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer.texture.getName(), 0));
-      assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
-      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    if (m_resizePending && m_resizeClock.getElapsedTime() >= m_resizeDelay) {
+      applyResize();
     }
 
-    onFramebufferResize(size);
-  }
+    m_pool.collect();
 
-  Vector2u RenderPipeline::getSize() const {
-    return m_window.getSize();
+    m_current = 0;
+    bindFrameTarget();
   }
 
-  void RenderPipeline::display() {
-    gf::PostProcessing postProcessing;
+  void RenderPipeline::drawPass(Effect& effect, const Texture& source, const RenderTargetPool::Target *target, const BlendMode& mode) {
+    if (target != nullptr) {
+      m_passSize = target->getSize();
+      bindFramebuffer(target->getFramebuffer());
+    } else {
+      m_passSize = m_window.getFramebufferSize();
+      bindFramebuffer(0);
+    }
 
-    // process the effects
+    m_inPass = true;
 
-    for (auto effect : m_effects) {
-      postProcessing.setTexture(m_buffers[m_current].texture);
-      postProcessing.setEffect(*effect);
+    // the pass draws the whole texture on the whole target
+    View view = getView();
+    Vector2u size = source.getSize();
+    setView(View(RectF(0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height))));
 
-      m_current = 1 - m_current;
-      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_buffers[m_current].name));
+    m_postProcessing.setTexture(source);
+    m_postProcessing.setEffect(effect);
 
-      RenderTarget::clear();
-      RenderTarget::draw(postProcessing);
-      glCheck(glFlush());
-    }
+    RenderStates states;
+    states.mode = mode;
 
-    // display to the window
+    RenderTarget::clear();
+    RenderTarget::draw(m_postProcessing, states);
 
-    postProcessing.setTexture(m_buffers[m_current].texture);
-    postProcessing.setEffect(m_defaultEffect);
+    // the pass must be drawn before the next framebuffer is bound or the
+    // uniforms of the effect change
+    flushRenderQueue();
 
-    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    setView(view);
+    m_inPass = false;
+  }
 
-    RenderTarget::clear();
-    RenderTarget::draw(postProcessing);
-    m_window.display();
+  void RenderPipeline::bindFrameTarget() {
+    if (!m_effects.empty()) {
+      // the last effect draws to the window, the second buffer is only
+      // needed between two effects
+      std::size_t count = m_effects.size() > 1 ? 2 : 1;
+      bool complete = true;
+
+      for (std::size_t i = 0; i < count; ++i) {
+        if (m_buffers[i] == nullptr) {
+          m_buffers[i] = m_pool.acquire(m_bufferSize);
+        }
+
+        if (m_buffers[i] == nullptr) {
+          complete = false;
+        }
+      }
 
-    // prepare for next frame
+      if (complete) {
+        bindFramebuffer(m_buffers[m_current]->getFramebuffer());
+        return;
+      }
 
-    m_current = 0;
-    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_buffers[m_current].name));
+      // without the buffers, the effects are not applied
+      releaseBuffers();
+    }
+
+    // without effects, the scene is drawn directly to the window
+    bindFramebuffer(0);
+  }
+
+  void RenderPipeline::releaseBuffers() {
+    for (auto& buffer : m_buffers) {
+      m_pool.release(buffer);
+      buffer = nullptr;
+    }
+  }
+
+  void RenderPipeline::applyResize() {
+    m_resizePending = false;
+    m_bufferSize = m_window.getFramebufferSize();
+
+    // the idle targets have the previous size, they are destroyed before
+    // the new buffers are allocated
+    releaseBuffers();
+    m_pool.clear();
+    bindFrameTarget();
+
+    onFramebufferResize(m_bufferSize);
   }
 
   void RenderPipeline::onFramebufferResize(Vector2u size) {
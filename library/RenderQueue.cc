@@ -0,0 +1,248 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/RenderQueue.h>
+
+#include <cassert>
+#include <algorithm>
+
+#include <gf/RenderTarget.h>
+#include <gf/Transform.h>
+
+#include "priv/Primitives.h"
+#include "priv/RadixSort.h"
+#include "priv/RenderQueueKey.h"
+
+namespace gf {
+inline namespace v1 {
+
+  RenderQueue::RenderQueue()
+  : m_layer(0)
+  , m_stateSorting(false)
+  , m_flushing(false)
+  , m_drawCount(0)
+  {
+
+  }
+
+  void RenderQueue::flush(RenderTarget& target) {
+    if (m_flushing || m_commands.empty()) {
+      return;
+    }
+
+    // the draw calls below would flush the queue again
+    m_flushing = true;
+
+    priv::radixSort(m_items, m_sortBuffer);
+
+    View savedView = target.getView();
+    std::size_t count = m_items.size();
+    std::size_t i = 0;
+
+    m_drawCount = 0;
+
+    while (i < count) {
+      const Command& first = m_commands[m_items[i].index];
+
+      m_drawVertices.clear();
+      m_drawPackedVertices.clear();
+      m_drawIndices.clear();
+
+      std::size_t j = i;
+
+      for (; j < count; ++j) {
+        const Command& command = m_commands[m_items[j].index];
+
+        if (command.view != first.view || command.shader != first.shader || command.texture != first.texture || command.mode != first.mode || command.type != first.type || command.packed != first.packed) {
+          break;
+        }
+
+        uint32_t base;
+
+        if (command.packed) {
+          base = static_cast<uint32_t>(m_drawPackedVertices.size());
+          m_drawPackedVertices.insert(m_drawPackedVertices.end(), &m_packedVertices[command.firstVertex], &m_packedVertices[command.firstVertex] + command.vertexCount);
+        } else {
+          base = static_cast<uint32_t>(m_drawVertices.size());
+          m_drawVertices.insert(m_drawVertices.end(), &m_vertices[command.firstVertex], &m_vertices[command.firstVertex] + command.vertexCount);
+        }
+
+        for (std::size_t k = 0; k < command.indexCount; ++k) {
+          m_drawIndices.push_back(base + m_indices[command.firstIndex + k]);
+        }
+      }
+
+      RenderStates states;
+      states.mode = m_modes[first.mode].blend;
+      states.lineWidth = m_modes[first.mode].lineWidth;
+      states.texture = m_textures[first.texture];
+      states.shader = m_shaders[first.shader];
+
+      target.setView(m_views[first.view]);
+
+      if (first.packed) {
+        target.draw(m_drawPackedVertices.data(), m_drawIndices.data(), m_drawIndices.size(), first.type, states);
+      } else {
+        target.draw(m_drawVertices.data(), m_drawIndices.data(), m_drawIndices.size(), first.type, states);
+      }
+
+      ++m_drawCount;
+
+      i = j;
+    }
+
+    target.setView(savedView);
+
+    clear();
+    m_flushing = false;
+  }
+
+  void RenderQueue::clear() {
+    m_commands.clear();
+    m_items.clear();
+    m_views.clear();
+    m_shaders.clear();
+    m_textures.clear();
+    m_textureIndices.clear();
+    m_modes.clear();
+    m_vertices.clear();
+    m_packedVertices.clear();
+    m_indices.clear();
+  }
+
+  void RenderQueue::submit(RenderTarget& target, const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    if (vertices == nullptr || count == 0) {
+      return;
+    }
+
+    if (m_commands.size() == priv::RenderQueueMaxCommandCount || m_views.size() == priv::RenderQueueMaxViewCount
+        || m_shaders.size() == priv::RenderQueueMaxShaderCount || m_textures.size() == priv::RenderQueueMaxTextureCount
+        || m_modes.size() == priv::RenderQueueMaxModeCount) {
+      flush(target);
+    }
+
+    Command command;
+    command.packed = (&format == &PackedVertex::getFormat());
+    command.firstVertex = command.packed ? m_packedVertices.size() : m_vertices.size();
+    command.vertexCount = indices != nullptr ? *std::max_element(indices, indices + count) + std::size_t(1) : count;
+    command.firstIndex = m_indices.size();
+
+    assert(indices == nullptr || type != PrimitiveType::Quads);
+
+    command.type = priv::appendListIndices(type, indices, count, 0, m_indices);
+    command.indexCount = m_indices.size() - command.firstIndex;
+
+    if (command.indexCount == 0) {
+      return;
+    }
+
+    /*
+     * vertices, in world coordinates
+     */
+
+    // the vertices keep their format, the colors of gf::Vertex would lose precision in gf::PackedVertex
+
+    if (command.packed) {
+      const PackedVertex *packed = static_cast<const PackedVertex *>(vertices);
+      m_packedVertices.insert(m_packedVertices.end(), packed, packed + command.vertexCount);
+
+      Vector2f *positions = &m_packedVertices[command.firstVertex].position;
+      transform(states.transform, positions, sizeof(PackedVertex), positions, sizeof(PackedVertex), command.vertexCount);
+    } else {
+      assert(&format == &Vertex::getFormat());
+      const Vertex *unpacked = static_cast<const Vertex *>(vertices);
+      m_vertices.insert(m_vertices.end(), unpacked, unpacked + command.vertexCount);
+
+      Vector2f *positions = &m_vertices[command.firstVertex].position;
+      transform(states.transform, positions, sizeof(Vertex), positions, sizeof(Vertex), command.vertexCount);
+    }
+
+    /*
+     * sort key
+     */
+
+    command.view = getViewIndex(target.getView());
+    command.shader = getShaderIndex(states.shader);
+    command.texture = getTextureIndex(states.texture);
+    command.mode = getModeIndex(states.mode, states.lineWidth);
+
+    uint64_t key;
+
+    if (m_stateSorting && states.mode == BlendNone) {
+      key = priv::getRenderQueueStateKey(m_layer, command.view, command.shader, command.texture, command.mode, command.type);
+    } else {
+      key = priv::getRenderQueueOrderedKey(m_layer, command.view, m_commands.size());
+    }
+
+    m_items.push_back({ key, static_cast<uint32_t>(m_commands.size()) });
+    m_commands.push_back(command);
+  }
+
+  static bool areViewsEqual(const View& lhs, const View& rhs) {
+    return lhs.getCenter() == rhs.getCenter() && lhs.getSize() == rhs.getSize() && lhs.getRotation() == rhs.getRotation() && lhs.getViewport() == rhs.getViewport();
+  }
+
+  std::size_t RenderQueue::getViewIndex(const View& view) {
+    // the view rarely changes, only the last one is checked
+    if (!m_views.empty() && areViewsEqual(m_views.back(), view)) {
+      return m_views.size() - 1;
+    }
+
+    m_views.push_back(view);
+    return m_views.size() - 1;
+  }
+
+  std::size_t RenderQueue::getShaderIndex(Shader *shader) {
+    auto it = std::find(m_shaders.begin(), m_shaders.end(), shader);
+
+    if (it != m_shaders.end()) {
+      return it - m_shaders.begin();
+    }
+
+    m_shaders.push_back(shader);
+    return m_shaders.size() - 1;
+  }
+
+  std::size_t RenderQueue::getTextureIndex(const BareTexture *texture) {
+    auto it = m_textureIndices.find(texture);
+
+    if (it != m_textureIndices.end()) {
+      return it->second;
+    }
+
+    std::size_t index = m_textures.size();
+    m_textures.push_back(texture);
+    m_textureIndices.insert(std::make_pair(texture, index));
+    return index;
+  }
+
+  std::size_t RenderQueue::getModeIndex(const BlendMode& blend, float lineWidth) {
+    for (std::size_t i = 0; i < m_modes.size(); ++i) {
+      if (m_modes[i].blend == blend && m_modes[i].lineWidth == lineWidth) {
+        return i;
+      }
+    }
+
+    m_modes.push_back({ blend, lineWidth });
+    return m_modes.size() - 1;
+  }
+
+}
+}
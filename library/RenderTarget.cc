@@ -25,16 +25,28 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
 
 #include <glad/glad.h>
 
 #include <gf/Drawable.h>
+#include <gf/Id.h>
 #include <gf/Image.h>
+#include <gf/Log.h>
+#include <gf/RenderQueue.h>
 #include <gf/Transform.h>
 #include <gf/Vertex.h>
 #include <gf/VertexBuffer.h>
 
 #include "priv/Debug.h"
+#include "priv/Instancing.h"
+#include "priv/Primitives.h"
+#include "priv/RenderCounters.h"
+#include "priv/StateCache.h"
 
 #include "config.h"
 
@@ -42,7 +54,13 @@ namespace gf {
 inline namespace v1 {
 
   RenderTarget::~RenderTarget() {
-
+    for (unsigned buffer : { m_vertexStream.name, m_indexStream.name, m_quadIndices.name, m_quadIndicesLarge.name }) {
+      if (buffer != 0) {
+        GLuint name = static_cast<GLuint>(buffer);
+        priv::getStateCache().forgetBuffer(name);
+        glCheck(glDeleteBuffers(1, &name));
+      }
+    }
   }
 
   void RenderTarget::clear(const Color4f& color) {
@@ -51,6 +69,7 @@ inline namespace v1 {
   }
 
   void RenderTarget::clear() {
+    flushRenderQueue();
     glCheck(glClear(GL_COLOR_BUFFER_BIT));
   }
 
@@ -125,6 +144,9 @@ inline namespace v1 {
         return GL_TRIANGLE_FAN;
       case PrimitiveType::Triangles:
         return GL_TRIANGLES;
+      case PrimitiveType::Quads:
+        // quads have no equivalent, they are drawn with drawQuads()
+        break;
     }
 
     assert(false);
@@ -132,44 +154,215 @@ inline namespace v1 {
   }
 
   void RenderTarget::draw(const Vertex *vertices, std::size_t count, PrimitiveType type, const RenderStates& states) {
-    if (vertices == nullptr || count == 0) {
+    if (m_renderQueue != nullptr) {
+      m_renderQueue->submit(*this, vertices, Vertex::getFormat(), nullptr, count, type, states);
       return;
     }
 
-    Locations locations;
-    drawStart(vertices, states, locations);
-    glCheck(glDrawArrays(getEnum(type), 0, count));
-    drawFinish(locations);
+    drawVertices(vertices, count, Vertex::getFormat(), type, states);
   }
 
   void RenderTarget::draw(const Vertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    if (m_renderQueue != nullptr) {
+      if (indices != nullptr) {
+        m_renderQueue->submit(*this, vertices, Vertex::getFormat(), indices, count, type, states);
+      }
+
+      return;
+    }
+
+    drawIndexedVertices(vertices, Vertex::getFormat(), indices, count, type, states);
+  }
+
+  void RenderTarget::draw(const PackedVertex *vertices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    if (m_renderQueue != nullptr) {
+      m_renderQueue->submit(*this, vertices, PackedVertex::getFormat(), nullptr, count, type, states);
+      return;
+    }
+
+    drawVertices(vertices, count, PackedVertex::getFormat(), type, states);
+  }
+
+  void RenderTarget::draw(const PackedVertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    if (m_renderQueue != nullptr) {
+      if (indices != nullptr) {
+        m_renderQueue->submit(*this, vertices, PackedVertex::getFormat(), indices, count, type, states);
+      }
+
+      return;
+    }
+
+    drawIndexedVertices(vertices, PackedVertex::getFormat(), indices, count, type, states);
+  }
+
+  void RenderTarget::draw(const Vertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    flushRenderQueue();
+    drawIndexedVertices(vertices, Vertex::getFormat(), indices, count, type, states);
+  }
+
+  void RenderTarget::draw(const PackedVertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    flushRenderQueue();
+    drawIndexedVertices(vertices, PackedVertex::getFormat(), indices, count, type, states);
+  }
+
+  /*
+   * All the draw calls go through these functions so that they are
+   * counted. An instance count of 0 means a non-instanced draw call.
+   */
+
+  static void drawArrays(GLenum mode, std::size_t first, std::size_t count, std::size_t instanceCount = 0) {
+    if (instanceCount > 0) {
+      priv::drawArraysInstanced(mode, first, count, instanceCount);
+      priv::getRenderCounters().countDraw(count * instanceCount);
+    } else {
+      glCheck(glDrawArrays(mode, first, count));
+      priv::getRenderCounters().countDraw(count);
+    }
+  }
+
+  static void drawElements(GLenum mode, std::size_t count, GLenum type, std::size_t offset, std::size_t instanceCount = 0) {
+    const void *indices = reinterpret_cast<const void *>(offset);
+
+    if (instanceCount > 0) {
+      priv::drawElementsInstanced(mode, count, type, indices, instanceCount);
+      priv::getRenderCounters().countDraw(count * instanceCount);
+    } else {
+      glCheck(glDrawElements(mode, count, type, indices));
+      priv::getRenderCounters().countDraw(count);
+    }
+  }
+
+  void RenderTarget::drawVertices(const void *vertices, std::size_t count, const VertexFormat& format, PrimitiveType type, const RenderStates& states, const TextureSlots *slots) {
+    if (vertices == nullptr || count == 0) {
+      return;
+    }
+
+    std::size_t offset = streamVertices(vertices, count, format);
+
+    if (type == PrimitiveType::Quads) {
+      drawQuads(offset, count, format, states, slots);
+      return;
+    }
+
+    drawStart(offset, format, states, slots);
+    drawArrays(getEnum(type), 0, count);
+  }
+
+  void RenderTarget::drawIndexedVertices(const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    assert(type != PrimitiveType::Quads);
+
     if (vertices == nullptr || indices == nullptr || count == 0) {
       return;
     }
 
-    Locations locations;
-    drawStart(vertices, states, locations);
+    std::size_t vertexCount = *std::max_element(indices, indices + count) + 1;
+    std::size_t offset = streamVertices(vertices, vertexCount, format);
+    drawStart(offset, format, states);
+
     static_assert(std::is_same<uint16_t, GLushort>::value, "GLushort is not the same as uint16_t.");
-    glCheck(glDrawElements(getEnum(type), count, GL_UNSIGNED_SHORT, indices));
-    drawFinish(locations);
+    std::size_t indexOffset = streamIndices(indices, count);
+    drawElements(getEnum(type), count, GL_UNSIGNED_SHORT, indexOffset);
+  }
+
+  void RenderTarget::drawIndexedVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type, const RenderStates& states) {
+    assert(type != PrimitiveType::Quads);
+
+    if (vertices == nullptr || indices == nullptr || count == 0) {
+      return;
+    }
+
+    uint32_t maxIndex = *std::max_element(indices, indices + count);
+
+    if (maxIndex <= std::numeric_limits<uint16_t>::max()) {
+      // half the size to upload
+      m_shortIndices.assign(indices, indices + count);
+      drawIndexedVertices(vertices, format, m_shortIndices.data(), count, type, states);
+      return;
+    }
+
+    if (GLAD_GL_OES_element_index_uint) {
+      std::size_t offset = streamVertices(vertices, std::size_t(maxIndex) + 1, format);
+      drawStart(offset, format, states);
+
+      static_assert(std::is_same<uint32_t, GLuint>::value, "GLuint is not the same as uint32_t.");
+      std::size_t indexOffset = streamIndices(indices, count);
+      drawElements(getEnum(type), count, GL_UNSIGNED_INT, indexOffset);
+      return;
+    }
+
+    /*
+     * split the primitives in chunks with 16-bit indices
+     */
+
+    if (!priv::isListPrimitive(type)) {
+      m_listIndices.clear();
+      type = priv::appendListIndices(type, indices, count, 0, m_listIndices);
+      indices = m_listIndices.data();
+      count = m_listIndices.size();
+    }
+
+    const uint8_t *source = static_cast<const uint8_t *>(vertices);
+
+    priv::splitIndices(type, indices, count, [&](const uint32_t *chunkVertices, std::size_t chunkVertexCount, const uint16_t *chunkIndices, std::size_t chunkIndexCount) {
+      m_splitVertices.resize(chunkVertexCount * format.stride);
+
+      for (std::size_t i = 0; i < chunkVertexCount; ++i) {
+        std::memcpy(&m_splitVertices[i * format.stride], source + chunkVertices[i] * format.stride, format.stride);
+      }
+
+      drawIndexedVertices(m_splitVertices.data(), format, chunkIndices, chunkIndexCount, type, states);
+    });
   }
 
+  /*
+   * Multiple draws use glMultiDraw*EXT when the context provides
+   * GL_EXT_multi_draw_arrays. Otherwise, all the primitives are converted
+   * to a single list of indices that is drawn in a single call. Quads are
+   * always converted, as they need an index buffer.
+   */
+
   void RenderTarget::draw(const Vertex *vertices, int *first, const std::size_t *count, std::size_t primcount, PrimitiveType type, const RenderStates& states) {
     if (vertices == nullptr || first == nullptr || count == nullptr || primcount == 0) {
       return;
     }
 
-    Locations locations;
-    drawStart(vertices, states, locations);
+    flushRenderQueue();
+
+    std::size_t vertexCount = 0;
 
-    // simulate glMultiDrawArrays
     for (std::size_t i = 0; i < primcount; ++i) {
       if (count[i] > 0) {
-        glCheck(glDrawArrays(getEnum(type), first[i], count[i]));
+        vertexCount = std::max(vertexCount, first[i] + count[i]);
       }
     }
 
-    drawFinish(locations);
+    if (vertexCount == 0) {
+      return;
+    }
+
+    const VertexFormat& format = Vertex::getFormat();
+
+    if (GLAD_GL_EXT_multi_draw_arrays && type != PrimitiveType::Quads) {
+      static_assert(std::is_same<int, GLint>::value && std::is_same<int, GLsizei>::value, "GLint or GLsizei is not the same as int.");
+      m_multiCounts.assign(count, count + primcount);
+
+      std::size_t offset = streamVertices(vertices, vertexCount, format);
+      drawStart(offset, format, states);
+      glCheck(glMultiDrawArraysEXT(getEnum(type), first, m_multiCounts.data(), primcount));
+      priv::getRenderCounters().countDraw(std::accumulate(count, count + primcount, std::size_t(0)));
+      return;
+    }
+
+    m_multiIndices.clear();
+    PrimitiveType listType = type;
+
+    for (std::size_t i = 0; i < primcount; ++i) {
+      if (count[i] > 0) {
+        listType = priv::appendListIndices(type, static_cast<const uint32_t *>(nullptr), count[i], first[i], m_multiIndices);
+      }
+    }
+
+    drawIndexedVertices(vertices, format, m_multiIndices.data(), m_multiIndices.size(), listType, states);
   }
 
   void RenderTarget::draw(const Vertex *vertices, const uint16_t **indices, const std::size_t *count, std::size_t primcount, PrimitiveType type, const RenderStates& states) {
@@ -177,86 +370,466 @@ inline namespace v1 {
       return;
     }
 
-    Locations locations;
-    drawStart(vertices, states, locations);
+    flushRenderQueue();
+
+    std::size_t vertexCount = 0;
+    std::size_t indexCount = 0;
 
-    // simulate glMultiDrawElements
     for (std::size_t i = 0; i < primcount; ++i) {
       if (count[i] > 0) {
-        glCheck(glDrawElements(getEnum(type), count[i], GL_UNSIGNED_SHORT, indices[i]));
+        vertexCount = std::max(vertexCount, *std::max_element(indices[i], indices[i] + count[i]) + std::size_t(1));
+        indexCount += count[i];
       }
     }
 
-    drawFinish(locations);
+    if (vertexCount == 0) {
+      return;
+    }
+
+    assert(type != PrimitiveType::Quads);
+
+    const VertexFormat& format = Vertex::getFormat();
+
+    if (GLAD_GL_EXT_multi_draw_arrays) {
+      // all the indices are uploaded at once
+      m_shortIndices.clear();
+      m_shortIndices.reserve(indexCount);
+
+      for (std::size_t i = 0; i < primcount; ++i) {
+        m_shortIndices.insert(m_shortIndices.end(), indices[i], indices[i] + count[i]);
+      }
+
+      std::size_t offset = streamVertices(vertices, vertexCount, format);
+      drawStart(offset, format, states);
+
+      std::size_t indexOffset = streamIndices(m_shortIndices.data(), m_shortIndices.size());
+
+      m_multiCounts.assign(count, count + primcount);
+      m_multiOffsets.resize(primcount);
+
+      for (std::size_t i = 0; i < primcount; ++i) {
+        m_multiOffsets[i] = reinterpret_cast<const void *>(indexOffset);
+        indexOffset += count[i] * sizeof(uint16_t);
+      }
+
+      glCheck(glMultiDrawElementsEXT(getEnum(type), m_multiCounts.data(), GL_UNSIGNED_SHORT, m_multiOffsets.data(), primcount));
+      priv::getRenderCounters().countDraw(indexCount);
+      return;
+    }
+
+    m_multiIndices.clear();
+    PrimitiveType listType = type;
+
+    for (std::size_t i = 0; i < primcount; ++i) {
+      if (count[i] > 0) {
+        listType = priv::appendListIndices(type, indices[i], count[i], 0, m_multiIndices);
+      }
+    }
+
+    drawIndexedVertices(vertices, format, m_multiIndices.data(), m_multiIndices.size(), listType, states);
   }
 
   void RenderTarget::draw(const VertexBuffer& buffer, const RenderStates& states) {
-    if (!buffer.hasArrayBuffer()) {
+    if (!buffer.hasArrayBuffer() || buffer.getCount() == 0) {
+      return;
+    }
+
+    flushRenderQueue();
+    drawBuffer(buffer, states, nullptr);
+  }
+
+  void RenderTarget::draw(const BatchVertex *vertices, std::size_t count, PrimitiveType type, const BareTexture *const *textures, std::size_t textureCount, const RenderStates& states) {
+    if (textures == nullptr || textureCount == 0) {
+      return;
+    }
+
+    flushRenderQueue();
+
+    if (textureCount > m_textureSlotCount) {
+      Log::warning(Log::Graphics, "Too many textures for a batch: %zu (max: %zu)\n", textureCount, m_textureSlotCount);
+      textureCount = m_textureSlotCount;
+    }
+
+    TextureSlots slots = { textures, textureCount };
+    drawVertices(vertices, count, BatchVertex::getFormat(), type, states, &slots);
+  }
+
+  void RenderTarget::drawInstanced(const VertexBuffer& buffer, const InstanceData *instances, std::size_t count, const RenderStates& states) {
+    if (!buffer.hasArrayBuffer() || buffer.getCount() == 0 || instances == nullptr || count == 0) {
       return;
     }
 
+    flushRenderQueue();
+
+    if (!priv::hasInstancedArrays()) {
+      drawExpandedInstances(buffer, instances, count, states);
+      return;
+    }
+
+    Instances data;
+    data.offset = streamVertices(instances, count, InstanceData::getFormat());
+    data.count = count;
+
+    drawBuffer(buffer, states, &data);
+  }
+
+  void RenderTarget::drawBuffer(const VertexBuffer& buffer, const RenderStates& states, const Instances *instances) {
     VertexBuffer::bind(&buffer);
 
-    Locations locations;
-    drawStart(nullptr, states, locations);
+    const VertexFormat& format = buffer.getFormat();
+    std::size_t instanceCount = instances != nullptr ? instances->count : 0;
+
+    if (!buffer.hasElementArrayBuffer()) {
+      if (buffer.getPrimitiveType() == PrimitiveType::Quads) {
+        drawQuads(0, buffer.getCount(), format, states, nullptr, instances);
+        return;
+      }
+
+      drawStart(0, format, states, nullptr, instances);
+      drawArrays(getEnum(buffer.getPrimitiveType()), 0, buffer.getCount(), instanceCount);
+      return;
+    }
+
+    GLenum type = getEnum(buffer.getPrimitiveType());
 
-    if (buffer.hasElementArrayBuffer()) {
-      glCheck(glDrawElements(getEnum(buffer.getPrimitiveType()), buffer.getCount(), GL_UNSIGNED_SHORT, nullptr));
+    if (!buffer.m_chunks.empty()) {
+      // a large buffer split in chunks with 16-bit indices
+      for (auto& chunk : buffer.m_chunks) {
+        drawStart(chunk.vertexOffset * format.stride, format, states, nullptr, instances);
+        drawElements(type, chunk.indexCount, GL_UNSIGNED_SHORT, chunk.indexOffset * sizeof(uint16_t), instanceCount);
+      }
+
+      return;
+    }
+
+    drawStart(0, format, states, nullptr, instances);
+    drawElements(type, buffer.getCount(), buffer.m_largeIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT, 0, instanceCount);
+
+    // the buffer stays bound, the next draw call will change it if necessary
+  }
+
+  /*
+   * Without instanced arrays, the vertices of the buffer are copied for
+   * each instance and transformed on the CPU. The indices are resolved
+   * during the copy, so that the instances can be concatenated. Strips,
+   * fans and loops can not be concatenated: they still share the upload and
+   * the setup, but each instance has its own draw call.
+   */
+
+  static void expandInstance(uint8_t *vertices, std::size_t count, const VertexFormat& format, const InstanceData& instance) {
+    for (std::size_t i = 0; i < format.count; ++i) {
+      const VertexAttribute& attribute = format.attributes[i];
+      uint8_t *data = vertices + attribute.offset;
+
+      if (attribute.id == "a_position"_id && attribute.type == VertexAttributeType::Float && attribute.size == 2) {
+        Vector2f *positions = reinterpret_cast<Vector2f *>(data);
+        transform(instance.transform, positions, format.stride, positions, format.stride, count);
+      } else if (attribute.id == "a_color"_id && attribute.size == 4) {
+        if (attribute.type == VertexAttributeType::Float) {
+          for (std::size_t j = 0; j < count; ++j) {
+            Color4f& color = *reinterpret_cast<Color4f *>(data + j * format.stride);
+            color *= instance.color;
+          }
+        } else if (attribute.normalized) {
+          for (std::size_t j = 0; j < count; ++j) {
+            Color4u& color = *reinterpret_cast<Color4u *>(data + j * format.stride);
+            color = Color::toRgba32(Color::fromRgba32(color) * instance.color);
+          }
+        }
+      }
+    }
+  }
+
+  void RenderTarget::drawExpandedInstances(const VertexBuffer& buffer, const InstanceData *instances, std::size_t count, const RenderStates& states) {
+    if (buffer.m_clientVertices.empty()) {
+      Log::warning(Log::Graphics, "The vertex buffer has no data in client memory for instanced drawing.\n");
+      return;
+    }
+
+    const VertexFormat& format = buffer.getFormat();
+    const uint8_t *vertices = buffer.m_clientVertices.data();
+    std::size_t vertexCount = buffer.getCount();
+    PrimitiveType type = buffer.getPrimitiveType();
+
+    std::size_t instanceSize = vertexCount * format.stride;
+    m_expandedVertices.resize(instanceSize * count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      uint8_t *expanded = m_expandedVertices.data() + i * instanceSize;
+
+      if (buffer.hasElementArrayBuffer()) {
+        for (std::size_t j = 0; j < vertexCount; ++j) {
+          std::memcpy(expanded + j * format.stride, vertices + buffer.m_clientIndices[j] * format.stride, format.stride);
+        }
+      } else {
+        std::memcpy(expanded, vertices, instanceSize);
+      }
+
+      expandInstance(expanded, vertexCount, format, instances[i]);
+    }
+
+    if (priv::isListPrimitive(type)) {
+      drawVertices(m_expandedVertices.data(), vertexCount * count, format, type, states);
+      return;
+    }
+
+    // strips, fans and loops can not be concatenated, they are converted to a list
+    m_multiIndices.clear();
+    PrimitiveType listType = type;
+
+    for (std::size_t i = 0; i < count; ++i) {
+      listType = priv::appendListIndices(type, static_cast<const uint32_t *>(nullptr), vertexCount, static_cast<uint32_t>(i * vertexCount), m_multiIndices);
+    }
+
+    drawIndexedVertices(m_expandedVertices.data(), format, m_multiIndices.data(), m_multiIndices.size(), listType, states);
+  }
+
+  /*
+   * Quads are drawn with a shared index buffer that contains the indices
+   * of the two triangles of each quad. 16-bit indices can address 16384
+   * quads. Larger batches use 32-bit indices if the context supports them,
+   * or are split in chunks of 16384 quads.
+   */
+
+  static constexpr std::size_t VerticesPerQuad = 4;
+  static constexpr std::size_t IndicesPerQuad = 6;
+  static constexpr std::size_t MaxShortQuadCount = 65536 / VerticesPerQuad;
+
+  template<typename T>
+  static std::vector<T> createQuadIndices(std::size_t quadCount) {
+    std::vector<T> indices(quadCount * IndicesPerQuad);
+
+    for (std::size_t i = 0; i < quadCount; ++i) {
+      T vertex = static_cast<T>(i * VerticesPerQuad);
+      T *index = &indices[i * IndicesPerQuad];
+
+      // same triangles as a triangle strip
+      index[0] = vertex + 0;
+      index[1] = vertex + 1;
+      index[2] = vertex + 2;
+      index[3] = vertex + 2;
+      index[4] = vertex + 1;
+      index[5] = vertex + 3;
+    }
+
+    return indices;
+  }
+
+  void RenderTarget::bindQuadIndices(QuadIndexBuffer& buffer, std::size_t quadCount, bool large) {
+    priv::StateCache& cache = priv::getStateCache();
+
+    if (buffer.name == 0) {
+      GLuint name;
+      glCheck(glGenBuffers(1, &name));
+      buffer.name = static_cast<unsigned>(name);
+    }
+
+    cache.bindElementArrayBuffer(buffer.name);
+
+    if (buffer.quadCount >= quadCount) {
+      return;
+    }
+
+    if (large) {
+      quadCount = std::max(quadCount, 2 * buffer.quadCount);
+      std::vector<uint32_t> indices = createQuadIndices<uint32_t>(quadCount);
+      glCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW));
+      priv::getRenderCounters().countBufferUpload(indices.size() * sizeof(uint32_t));
     } else {
-      glCheck(glDrawArrays(getEnum(buffer.getPrimitiveType()), 0, buffer.getCount()));
+      quadCount = MaxShortQuadCount;
+      std::vector<uint16_t> indices = createQuadIndices<uint16_t>(quadCount);
+      glCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW));
+      priv::getRenderCounters().countBufferUpload(indices.size() * sizeof(uint16_t));
     }
 
-    drawFinish(locations);
+    buffer.quadCount = quadCount;
+  }
+
+  void RenderTarget::drawQuads(std::size_t offset, std::size_t count, const VertexFormat& format, const RenderStates& states, const TextureSlots *slots, const Instances *instances) {
+    std::size_t quadCount = count / VerticesPerQuad;
+
+    if (quadCount == 0) {
+      return;
+    }
+
+    std::size_t instanceCount = instances != nullptr ? instances->count : 0;
+
+    if (quadCount > MaxShortQuadCount && GLAD_GL_OES_element_index_uint) {
+      bindQuadIndices(m_quadIndicesLarge, quadCount, true);
+      drawStart(offset, format, states, slots, instances);
+      drawElements(GL_TRIANGLES, quadCount * IndicesPerQuad, GL_UNSIGNED_INT, 0, instanceCount);
+      return;
+    }
+
+    bindQuadIndices(m_quadIndices, MaxShortQuadCount, false);
+
+    for (std::size_t first = 0; first < quadCount; first += MaxShortQuadCount) {
+      std::size_t chunk = std::min(quadCount - first, MaxShortQuadCount);
+      drawStart(offset + first * VerticesPerQuad * format.stride, format, states, slots, instances);
+      drawElements(GL_TRIANGLES, chunk * IndicesPerQuad, GL_UNSIGNED_SHORT, 0, instanceCount);
+    }
+  }
 
-    VertexBuffer::bind(nullptr);
+  /*
+   * The data from client memory is copied in streaming buffers. The data
+   * is appended after the data of the previous draw calls. When the buffer
+   * is full, it is orphaned: the driver gives a fresh storage while the
+   * previous one is still read by the GPU, so that writing never waits for
+   * a draw call in flight.
+   */
+
+  static constexpr std::size_t StreamAlignment = 32;
+  static constexpr std::size_t VertexStreamCapacity = 1024 * 1024;
+  static constexpr std::size_t IndexStreamCapacity = 256 * 1024;
+
+  std::size_t RenderTarget::streamVertices(const void *vertices, std::size_t count, const VertexFormat& format) {
+    priv::getStateCache().bindArrayBuffer(getStreamName(m_vertexStream, VertexStreamCapacity));
+    return streamData(m_vertexStream, GL_ARRAY_BUFFER, vertices, count * format.stride);
   }
 
-  void RenderTarget::drawStart(const Vertex *vertices, const RenderStates& states, Locations& locations) {
-    /*
-     * texture
-     */
+  std::size_t RenderTarget::streamIndices(const uint16_t *indices, std::size_t count) {
+    priv::getStateCache().bindElementArrayBuffer(getStreamName(m_indexStream, IndexStreamCapacity));
+    return streamData(m_indexStream, GL_ELEMENT_ARRAY_BUFFER, indices, count * sizeof(uint16_t));
+  }
 
-    const BareTexture *texture = states.texture;
+  std::size_t RenderTarget::streamIndices(const uint32_t *indices, std::size_t count) {
+    priv::getStateCache().bindElementArrayBuffer(getStreamName(m_indexStream, IndexStreamCapacity));
+    return streamData(m_indexStream, GL_ELEMENT_ARRAY_BUFFER, indices, count * sizeof(uint32_t));
+  }
 
-    if (texture == nullptr) {
-      texture = &m_defaultTexture;
+  unsigned RenderTarget::getStreamName(StreamBuffer& stream, std::size_t capacity) {
+    if (stream.name == 0) {
+      GLuint name;
+      glCheck(glGenBuffers(1, &name));
+      stream.name = static_cast<unsigned>(name);
+      stream.capacity = capacity;
+      stream.offset = capacity; // force allocation at first use
     }
 
-    /*
-     * shader
-     */
+    return stream.name;
+  }
 
-    Shader *shader = states.shader;
+  std::size_t RenderTarget::streamData(StreamBuffer& stream, unsigned target, const void *data, std::size_t size) {
+    // the buffer must be bound to the target before
 
-    if (shader == nullptr) {
-      switch (texture->getFormat()) {
-        case BareTexture::Format::Alpha:
-          shader = &m_defaultAlphaShader;
-          break;
-        case BareTexture::Format::Color:
-          shader = &m_defaultShader;
-          break;
+    if (size > stream.capacity) {
+      while (stream.capacity < size) {
+        stream.capacity *= 2;
       }
+
+      stream.offset = stream.capacity;
+    }
+
+    if (stream.offset + size > stream.capacity) {
+      // orphan the current storage
+      glCheck(glBufferData(target, stream.capacity, nullptr, GL_STREAM_DRAW));
+      stream.offset = 0;
+    }
+
+    std::size_t offset = stream.offset;
+    void *ptr = nullptr;
+
+    if (GLAD_GL_EXT_map_buffer_range && GLAD_GL_OES_mapbuffer) {
+      // the range is not used by any draw call, no need to synchronize
+      glCheck(ptr = glMapBufferRangeEXT(target, offset, size, GL_MAP_WRITE_BIT_EXT | GL_MAP_INVALIDATE_RANGE_BIT_EXT | GL_MAP_UNSYNCHRONIZED_BIT_EXT));
+    }
+
+    if (ptr != nullptr) {
+      std::memcpy(ptr, data, size);
+      glCheck(glUnmapBufferOES(target));
+    } else {
+      glCheck(glBufferSubData(target, offset, size, data));
+    }
+
+    priv::getRenderCounters().countBufferUpload(size);
+
+    stream.offset = (offset + size + StreamAlignment - 1) / StreamAlignment * StreamAlignment;
+    return offset;
+  }
+
+  constexpr std::size_t RenderTarget::MaxTextureSlots;
+
+  static constexpr Id TextureSlotIds[RenderTarget::MaxTextureSlots] = {
+    "u_texture0"_id, "u_texture1"_id, "u_texture2"_id, "u_texture3"_id,
+    "u_texture4"_id, "u_texture5"_id, "u_texture6"_id, "u_texture7"_id,
+  };
+
+  static GLenum getEnum(VertexAttributeType type) {
+    switch (type) {
+      case VertexAttributeType::Float:
+        return GL_FLOAT;
+      case VertexAttributeType::UnsignedByte:
+        return GL_UNSIGNED_BYTE;
     }
 
-    shader->setUniform("u_texture", *texture);
+    assert(false);
+    return GL_FLOAT;
+  }
+
+  void RenderTarget::drawStart(std::size_t offset, const VertexFormat& format, const RenderStates& states, const TextureSlots *slots, const Instances *instances) {
+    Shader *shader = states.shader;
+
+    if (slots != nullptr) {
+      /*
+       * textures and shader of a batch
+       */
+
+      if (shader == nullptr) {
+        shader = &m_defaultBatchShader;
+      }
+
+      for (std::size_t i = 0; i < m_textureSlotCount; ++i) {
+        // unused slots get the default texture, so that no sampler keeps a texture from a previous batch
+        const BareTexture *texture = i < slots->count ? slots->textures[i] : &m_defaultTexture;
+        shader->setUniform(TextureSlotIds[i], *texture);
+      }
+    } else {
+      /*
+       * texture
+       */
+
+      const BareTexture *texture = states.texture;
+
+      if (texture == nullptr) {
+        texture = &m_defaultTexture;
+      }
+
+      /*
+       * shader
+       */
+
+      if (shader == nullptr) {
+        switch (texture->getFormat()) {
+          case BareTexture::Format::Alpha:
+            shader = instances != nullptr ? &m_defaultInstancedAlphaShader : &m_defaultAlphaShader;
+            break;
+          case BareTexture::Format::Color:
+            shader = instances != nullptr ? &m_defaultInstancedShader : &m_defaultShader;
+            break;
+        }
+      }
+
+      shader->setUniformTexture(shader->getUniform("u_texture"_id, "u_texture"), *texture);
+    }
 
     /*
      * transform
      */
 
     Matrix3f mat = getView().getTransform() * states.transform;
-    shader->setUniform("u_transform", mat);
+    shader->setUniformValues(shader->getUniform("u_transform"_id, "u_transform"), Shader::UniformType::Mat3, mat.data, 9);
 
     /*
      * blend mode
      */
 
-    glCheck(glBlendEquationSeparate(getEnum(states.mode.colorEquation), getEnum(states.mode.alphaEquation)));
-    glCheck(glBlendFuncSeparate(
+    priv::StateCache& cache = priv::getStateCache();
+
+    cache.setBlend(
+      getEnum(states.mode.colorEquation), getEnum(states.mode.alphaEquation),
       getEnum(states.mode.colorSrcFactor), getEnum(states.mode.colorDstFactor),
       getEnum(states.mode.alphaSrcFactor), getEnum(states.mode.alphaDstFactor)
-    ));
+    );
 
     /*
      * line width
@@ -272,7 +845,7 @@ inline namespace v1 {
 
     RectI viewport = getViewport(getView());
     int bottom = getSize().height - (viewport.top + viewport.height);
-    glCheck(glViewport(viewport.left, bottom, viewport.width, viewport.height));
+    cache.setViewport(viewport.left, bottom, viewport.width, viewport.height);
 
     /*
      * prepare data
@@ -280,38 +853,121 @@ inline namespace v1 {
 
     Shader::bind(shader);
 
-    int positionLoc = shader->getAttributeLocation("a_position");
-    int colorLoc = shader->getAttributeLocation("a_color");
-    int texCoordsLoc = shader->getAttributeLocation("a_texCoords");
+    assert(format.count <= priv::StateCache::MaxAttributes);
+    int locations[priv::StateCache::MaxAttributes];
+    uint32_t attributes = 0;
 
-    glCheck(glEnableVertexAttribArray(positionLoc));
-    glCheck(glEnableVertexAttribArray(colorLoc));
-    glCheck(glEnableVertexAttribArray(texCoordsLoc));
+    for (std::size_t i = 0; i < format.count; ++i) {
+      int loc = shader->getAttributeLocation(format.attributes[i].id, format.attributes[i].name);
+      locations[i] = loc;
 
-    const void *positionPointer = vertices ? &vertices[0].position : reinterpret_cast<const void *>(offsetof(Vertex, position));
-    const void *colorPointer = vertices ? &vertices[0].color : reinterpret_cast<const void *>(offsetof(Vertex, color));
-    const void *texCoordsPointer = vertices ? &vertices[0].texCoords : reinterpret_cast<const void *>(offsetof(Vertex, texCoords));
+      if (loc >= 0 && static_cast<std::size_t>(loc) < priv::StateCache::MaxAttributes) {
+        attributes |= UINT32_C(1) << loc;
+      }
+    }
 
-    glCheck(glVertexAttribPointer(positionLoc, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), positionPointer));
-    glCheck(glVertexAttribPointer(colorLoc, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), colorPointer));
-    glCheck(glVertexAttribPointer(texCoordsLoc, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), texCoordsPointer));
+    const VertexFormat& instanceFormat = InstanceData::getFormat();
+    int instanceLocations[priv::StateCache::MaxAttributes];
+    uint32_t divisors = 0;
 
-    locations.positionLoc = positionLoc;
-    locations.colorLoc = colorLoc;
-    locations.texCoordsLoc = texCoordsLoc;
-  }
+    if (instances != nullptr) {
+      for (std::size_t i = 0; i < instanceFormat.count; ++i) {
+        int loc = shader->getAttributeLocation(instanceFormat.attributes[i].id, instanceFormat.attributes[i].name);
+        instanceLocations[i] = loc;
 
-  void RenderTarget::drawFinish(const Locations& locations) {
-    glCheck(glDisableVertexAttribArray(locations.positionLoc));
-    glCheck(glDisableVertexAttribArray(locations.colorLoc));
-    glCheck(glDisableVertexAttribArray(locations.texCoordsLoc));
-  }
+        if (loc >= 0 && static_cast<std::size_t>(loc) < priv::StateCache::MaxAttributes) {
+          attributes |= UINT32_C(1) << loc;
+          divisors |= UINT32_C(1) << loc;
+        }
+      }
+    }
 
+    cache.setEnabledAttributes(attributes);
+
+    if (priv::hasInstancedArrays()) {
+      cache.setAttributeDivisors(divisors);
+    }
+
+    // the vertices are in the array buffer that is currently bound
+    for (std::size_t i = 0; i < format.count; ++i) {
+      if (locations[i] < 0) {
+        continue;
+      }
+
+      const VertexAttribute& attribute = format.attributes[i];
+      const void *pointer = reinterpret_cast<const void *>(offset + attribute.offset);
+      glCheck(glVertexAttribPointer(locations[i], attribute.size, getEnum(attribute.type), attribute.normalized ? GL_TRUE : GL_FALSE, format.stride, pointer));
+    }
+
+    if (instances == nullptr) {
+      return;
+    }
+
+    // the instances are in the vertex stream
+    cache.bindArrayBuffer(m_vertexStream.name);
+
+    for (std::size_t i = 0; i < instanceFormat.count; ++i) {
+      if (instanceLocations[i] < 0) {
+        continue;
+      }
+
+      const VertexAttribute& attribute = instanceFormat.attributes[i];
+      const void *pointer = reinterpret_cast<const void *>(instances->offset + attribute.offset);
+      glCheck(glVertexAttribPointer(instanceLocations[i], attribute.size, getEnum(attribute.type), attribute.normalized ? GL_TRUE : GL_FALSE, instanceFormat.stride, pointer));
+    }
+  }
 
   void RenderTarget::draw(Drawable& drawable, const RenderStates& states) {
     drawable.draw(*this, states);
   }
 
+  void RenderTarget::setRenderQueue(RenderQueue *queue) {
+    flushRenderQueue();
+    m_renderQueue = queue;
+  }
+
+  void RenderTarget::flushRenderQueue() {
+    if (m_renderQueue != nullptr) {
+      m_renderQueue->flush(*this);
+    }
+  }
+
+  StateCacheCounters RenderTarget::getStateCacheCounters() const {
+    const priv::StateCache& cache = priv::getStateCache();
+
+    StateCacheCounters counters;
+    counters.changed = cache.getChangedCount();
+    counters.skipped = cache.getSkippedCount();
+    return counters;
+  }
+
+  void RenderTarget::resetStateCacheCounters() {
+    priv::getStateCache().resetCounters();
+  }
+
+  void RenderTarget::invalidateStateCache() {
+    priv::getStateCache().invalidate();
+  }
+
+  RenderStats RenderTarget::getStats() const {
+    const priv::RenderCounters& counters = priv::getRenderCounters();
+
+    RenderStats stats;
+    stats.drawCalls = counters.drawCalls;
+    stats.vertices = counters.vertices;
+    stats.textureBinds = counters.textureBinds;
+    stats.shaderSwitches = counters.shaderSwitches;
+    stats.bufferUploads = counters.bufferUploads;
+    stats.bufferUploadSize = counters.bufferUploadSize;
+    stats.textureUploads = counters.textureUploads;
+    stats.framebufferSwitches = counters.framebufferSwitches;
+    return stats;
+  }
+
+  void RenderTarget::resetStats() {
+    priv::getRenderCounters() = priv::RenderCounters();
+  }
+
   RectI RenderTarget::getViewport(const View& view) const {
     auto size = getSize();
     const RectF& viewport = view.getViewport();
@@ -383,6 +1039,10 @@ inline namespace v1 {
   void RenderTarget::initialize() {
     glCheck(glEnable(GL_BLEND));
 
+    GLint textureUnits = 0;
+    glCheck(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &textureUnits));
+    m_textureSlotCount = std::min(static_cast<std::size_t>(std::max(textureUnits, 1)), MaxTextureSlots);
+
     initializeViews();
     initializeTexture();
     initializeShader();
@@ -397,12 +1057,14 @@ inline namespace v1 {
 
     if (static_cast<unsigned>(boundFrameBuffer) != name) {
       glCheck(glBindFramebuffer(GL_FRAMEBUFFER, name));
+      ++priv::getRenderCounters().framebufferSwitches;
     }
 
     glCheck(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
 
     if (static_cast<unsigned>(boundFrameBuffer) != name) {
       glCheck(glBindFramebuffer(GL_FRAMEBUFFER, boundFrameBuffer));
+      ++priv::getRenderCounters().framebufferSwitches;
     }
 
     Image image;
@@ -425,6 +1087,16 @@ inline namespace v1 {
 
     Path alphaFragmentShaderPath = Path(GF_DATADIR) / "shaders/default_alpha.frag";
     m_defaultAlphaShader.loadFromFile(vertexShaderPath, alphaFragmentShaderPath);
+
+    Path batchVertexShaderPath = Path(GF_DATADIR) / "shaders/default_batch.vert";
+    Path batchFragmentShaderPath = Path(GF_DATADIR) / "shaders/default_batch.frag";
+    m_defaultBatchShader.loadFromFile(batchVertexShaderPath, batchFragmentShaderPath);
+
+    if (priv::hasInstancedArrays()) {
+      Path instancedVertexShaderPath = Path(GF_DATADIR) / "shaders/default_instanced.vert";
+      m_defaultInstancedShader.loadFromFile(instancedVertexShaderPath, fragmentShaderPath);
+      m_defaultInstancedAlphaShader.loadFromFile(instancedVertexShaderPath, alphaFragmentShaderPath);
+    }
   }
 
   void RenderTarget::initializeTexture() {
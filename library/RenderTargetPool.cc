@@ -0,0 +1,162 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/RenderTargetPool.h>
+
+#include <cassert>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include <gf/Log.h>
+
+#include "priv/Debug.h"
+#include "priv/RenderCounters.h"
+
+namespace gf {
+inline namespace v1 {
+
+  RenderTargetPool::RenderTargetPool()
+  : m_maxIdleFrames(60)
+  {
+
+  }
+
+  RenderTargetPool::~RenderTargetPool() {
+    for (auto& target : m_targets) {
+      destroy(*target);
+    }
+  }
+
+  RenderTargetPool::Target *RenderTargetPool::acquire(Vector2u size) {
+    // first, an idle target with the right size
+    for (auto& target : m_targets) {
+      if (!target->m_used && target->getSize() == size) {
+        target->m_used = true;
+        target->m_idleFrames = 0;
+        return target.get();
+      }
+    }
+
+    // then, an idle target with another size, its framebuffer is kept, but
+    // not one released in this frame, it would be reallocated every frame
+    for (auto& target : m_targets) {
+      if (!target->m_used && target->m_idleFrames > 0) {
+        if (!allocate(*target, size)) {
+          return nullptr;
+        }
+
+        target->m_used = true;
+        target->m_idleFrames = 0;
+        return target.get();
+      }
+    }
+
+    std::unique_ptr<Target> target(new Target);
+
+    if (!allocate(*target, size)) {
+      destroy(*target);
+      return nullptr;
+    }
+
+    target->m_used = true;
+    m_targets.push_back(std::move(target));
+    return m_targets.back().get();
+  }
+
+  void RenderTargetPool::release(Target *target) {
+    if (target == nullptr) {
+      return;
+    }
+
+    assert(target->m_used);
+    target->m_used = false;
+    target->m_idleFrames = 0;
+  }
+
+  void RenderTargetPool::collect() {
+    auto it = std::remove_if(m_targets.begin(), m_targets.end(), [this](std::unique_ptr<Target>& target) {
+      if (target->m_used) {
+        return false;
+      }
+
+      ++target->m_idleFrames;
+
+      if (target->m_idleFrames <= m_maxIdleFrames) {
+        return false;
+      }
+
+      destroy(*target);
+      return true;
+    });
+
+    m_targets.erase(it, m_targets.end());
+  }
+
+  void RenderTargetPool::clear() {
+    auto it = std::remove_if(m_targets.begin(), m_targets.end(), [this](std::unique_ptr<Target>& target) {
+      if (target->m_used) {
+        return false;
+      }
+
+      destroy(*target);
+      return true;
+    });
+
+    m_targets.erase(it, m_targets.end());
+  }
+
+  bool RenderTargetPool::allocate(Target& target, Vector2u size) {
+    if (!target.m_texture.create(size)) {
+      Log::error(Log::Graphics, "Could not create an offscreen target: %ux%u\n", size.width, size.height);
+      return false;
+    }
+
+    target.m_texture.setSmooth();
+
+    if (target.m_framebuffer == 0) {
+      GLuint name;
+      glCheck(glGenFramebuffers(1, &name));
+      target.m_framebuffer = static_cast<unsigned>(name);
+    }
+
+    GLint boundFramebuffer;
+    glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &boundFramebuffer));
+
+    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, target.m_framebuffer));
+    ++priv::getRenderCounters().framebufferSwitches;
+    glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.m_texture.getName(), 0));
+    assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, boundFramebuffer));
+    ++priv::getRenderCounters().framebufferSwitches;
+
+    return true;
+  }
+
+  void RenderTargetPool::destroy(Target& target) {
+    if (target.m_framebuffer != 0) {
+      GLuint name = static_cast<GLuint>(target.m_framebuffer);
+      glCheck(glDeleteFramebuffers(1, &name));
+      target.m_framebuffer = 0;
+    }
+  }
+
+}
+}
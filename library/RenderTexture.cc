@@ -28,6 +28,7 @@
 #include <glad/glad.h>
 
 #include "priv/Debug.h"
+#include "priv/RenderCounters.h"
 
 namespace gf {
 inline namespace v1 {
@@ -47,6 +48,12 @@ inline namespace v1 {
   }
 
   bool RenderTexture::create(Vector2u size) {
+    if (m_name != 0 && size == m_texture.getSize()) {
+      // the storage is reused
+      initializeViews();
+      return true;
+    }
+
     if (!m_texture.create(size)) {
       return false;
     }
@@ -54,20 +61,23 @@ inline namespace v1 {
     m_texture.setSmooth();
     Texture::bind(nullptr);
 
-    initialize();
-
-
     if (m_name == 0) {
+      initialize();
+
       GLuint name;
       glCheck(glGenFramebuffers(1, &name));
       m_name = static_cast<unsigned>(name);
+    } else {
+      initializeViews();
     }
 
 
     glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_name));
+    ++priv::getRenderCounters().framebufferSwitches;
     glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture.getName(), 0));
     assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
     glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    ++priv::getRenderCounters().framebufferSwitches;
 
     return true;
   }
@@ -79,10 +89,12 @@ inline namespace v1 {
   void RenderTexture::setActive() {
     if (m_name != 0) {
       glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_name));
+      ++priv::getRenderCounters().framebufferSwitches;
     }
   }
 
   void RenderTexture::display() {
+    flushRenderQueue();
     glCheck(glFlush());
   }
 
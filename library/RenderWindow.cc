@@ -28,6 +28,7 @@
 #include <gf/Window.h>
 
 #include "priv/Debug.h"
+#include "priv/RenderCounters.h"
 
 namespace gf {
 inline namespace v1 {
@@ -44,9 +45,11 @@ inline namespace v1 {
 
   void RenderWindow::setActive() {
      glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+     ++priv::getRenderCounters().framebufferSwitches;
   }
 
   void RenderWindow::display() {
+    flushRenderQueue();
     m_window.display();
   }
 
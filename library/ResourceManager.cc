@@ -20,6 +20,8 @@
  */
 #include <gf/ResourceManager.h>
 
+#include <gf/Image.h>
+
 namespace gf {
 inline namespace v1 {
 
@@ -44,5 +46,28 @@ inline namespace v1 {
 
   }
 
+  const TextureAtlas *ResourceManager::getPackedTexture(const Path& path) {
+    std::string name = path.string();
+    const TextureAtlas *atlas = m_packer.findAtlas(name);
+
+    if (atlas != nullptr) {
+      return atlas;
+    }
+
+    Path absolutePath = getAbsolutePath(path);
+
+    if (absolutePath.empty()) {
+      return nullptr;
+    }
+
+    Image image;
+
+    if (!image.loadFromFile(absolutePath)) {
+      return nullptr;
+    }
+
+    return m_packer.addImage(name, image);
+  }
+
 }
 }
@@ -23,6 +23,7 @@
  */
 #include <gf/Shader.h>
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <memory>
@@ -33,6 +34,7 @@
 #include <gf/Log.h>
 
 #include "priv/Debug.h"
+#include "priv/StateCache.h"
 
 namespace gf {
 inline namespace v1 {
@@ -122,12 +124,14 @@ inline namespace v1 {
 
   Shader::Shader()
   : m_program(0)
+  , m_dirty(false)
   {
 
   }
 
   Shader::~Shader() {
     if (m_program != 0) {
+      priv::getStateCache().forgetProgram(m_program);
       glCheck(glDeleteProgram(m_program));
     }
   }
@@ -184,6 +188,7 @@ inline namespace v1 {
     assert(vertexShaderCode || fragmentShaderCode);
 
     if (m_program != 0) {
+      priv::getStateCache().forgetProgram(m_program);
       glCheck(glDeleteProgram(m_program));
     }
 
@@ -218,106 +223,258 @@ inline namespace v1 {
       return false;
     }
 
+    queryLocations();
     return true;
   }
 
-  struct Shader::Guard {
-    explicit Guard(Shader& shader)
-    : m_prev(0)
-    , m_curr(shader.m_program)
-    {
-      GLint prev = 0;
-      glCheck(glGetIntegerv(GL_CURRENT_PROGRAM, &prev));
-      m_prev = prev;
+  static std::string getVariableName(const char *name, GLsizei length) {
+    std::string variable(name, length);
 
-      if (m_prev != m_curr) {
-        glCheck(glUseProgram(m_curr));
+    // arrays are reported as 'name[0]', use 'name' instead
+    static const std::string ArraySuffix = "[0]";
+
+    if (variable.size() > ArraySuffix.size() && variable.compare(variable.size() - ArraySuffix.size(), ArraySuffix.size(), ArraySuffix) == 0) {
+      variable.erase(variable.size() - ArraySuffix.size());
+    }
+
+    return variable;
+  }
+
+  void Shader::queryLocations() {
+    m_uniformIndices.clear();
+    m_uniforms.clear();
+    m_attributes.clear();
+    m_dirty = false;
+
+    GLint count = 0;
+    GLint maxLength = 0;
+
+    // uniforms
+
+    glCheck(glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count));
+    glCheck(glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    if (count > 0 && maxLength > 0) {
+      std::unique_ptr<char[]> name(new char[maxLength]);
+      int unit = 0;
+
+      for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glCheck(glGetActiveUniform(m_program, i, maxLength, &length, &size, &type, name.get()));
+
+        // each element of an array has its own location, the first one is
+        // also known by the name of the array
+        std::string variable = getVariableName(name.get(), length);
+        bool isArray = size > 1 || variable.size() != static_cast<std::size_t>(length);
+
+        for (GLint element = 0; element < size; ++element) {
+          std::string elementName = variable;
+
+          if (isArray) {
+            elementName += '[' + std::to_string(element) + ']';
+          }
+
+          GLint loc;
+          glCheck(loc = glGetUniformLocation(m_program, elementName.c_str()));
+
+          if (loc == -1) {
+            continue;
+          }
+
+          Uniform uniform;
+          uniform.location = loc;
+          uniform.type = UniformType::None;
+          uniform.dirty = false;
+          std::fill(std::begin(uniform.values), std::end(uniform.values), 0.0f);
+          uniform.integer = 0;
+          uniform.unit = -1;
+          uniform.texture = nullptr;
+
+          if (type == GL_SAMPLER_2D) {
+            // each sampler gets its own texture unit
+            uniform.type = UniformType::Int;
+            uniform.dirty = true;
+            uniform.integer = uniform.unit = unit++;
+            m_dirty = true;
+          }
+
+          if (isArray && element == 0) {
+            m_uniformIndices.insert(std::make_pair(hash(variable), m_uniforms.size()));
+          }
+
+          m_uniformIndices.insert(std::make_pair(hash(elementName), m_uniforms.size()));
+          m_uniforms.push_back(uniform);
+        }
       }
     }
 
-    ~Guard() {
-      if (m_prev != m_curr) {
-        glCheck(glUseProgram(m_prev));
+    // attributes
+
+    glCheck(glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTES, &count));
+    glCheck(glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength));
+
+    if (count > 0 && maxLength > 0) {
+      std::unique_ptr<char[]> name(new char[maxLength]);
+
+      for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glCheck(glGetActiveAttrib(m_program, i, maxLength, &length, &size, &type, name.get()));
+
+        GLint loc;
+        glCheck(loc = glGetAttribLocation(m_program, name.get()));
+
+        if (loc != -1) {
+          m_attributes.insert(std::make_pair(hash(getVariableName(name.get(), length)), loc));
+        }
       }
     }
+  }
+
+  void Shader::setUniformValues(Uniform *uniform, UniformType type, const float *values, std::size_t count) {
+    if (uniform == nullptr) {
+      return;
+    }
+
+    if (uniform->type == type && std::equal(values, values + count, uniform->values)) {
+      return;
+    }
+
+    uniform->type = type;
+    std::copy(values, values + count, uniform->values);
+    uniform->dirty = true;
+    m_dirty = true;
+  }
+
+  void Shader::setUniformInteger(Uniform *uniform, int integer) {
+    if (uniform == nullptr) {
+      return;
+    }
+
+    if (uniform->type == UniformType::Int && uniform->integer == integer) {
+      return;
+    }
+
+    uniform->type = UniformType::Int;
+    uniform->integer = integer;
+    uniform->dirty = true;
+    m_dirty = true;
+  }
+
+  void Shader::setUniformTexture(Uniform *uniform, const BareTexture& tex) {
+    if (uniform == nullptr) {
+      return;
+    }
 
-    GLuint m_prev;
-    GLuint m_curr;
-  };
+    uniform->texture = &tex;
+  }
 
   void Shader::setUniform(const std::string& name, float val) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniform1f(loc, val));
+    setUniformValues(getUniform(name), UniformType::Float, &val, 1);
   }
 
   void Shader::setUniform(const std::string& name, int val) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniform1i(loc, val));
+    setUniformInteger(getUniform(name), val);
   }
 
   void Shader::setUniform(const std::string& name, const Vector2f& vec) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniform2f(loc, vec.x, vec.y));
+    setUniformValues(getUniform(name), UniformType::Vec2, vec.data, 2);
   }
 
   void Shader::setUniform(const std::string& name, const Vector3f& vec) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniform3f(loc, vec.x, vec.y, vec.z));
+    setUniformValues(getUniform(name), UniformType::Vec3, vec.data, 3);
   }
 
   void Shader::setUniform(const std::string& name, const Vector4f& vec) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniform4f(loc, vec.x, vec.y, vec.z, vec.w));
+    setUniformValues(getUniform(name), UniformType::Vec4, vec.data, 4);
   }
 
   void Shader::setUniform(const std::string& name, const Matrix3f& mat) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniformMatrix3fv(loc, 1, GL_FALSE, mat.data));
+    setUniformValues(getUniform(name), UniformType::Mat3, mat.data, 9);
   }
 
   void Shader::setUniform(const std::string& name, const Matrix4f& mat) {
-    Guard guard(*this);
-    int loc = getUniformLocation(name);
-    glCheck(glUniformMatrix4fv(loc, 1, GL_FALSE, mat.data));
+    setUniformValues(getUniform(name), UniformType::Mat4, mat.data, 16);
   }
 
   void Shader::setUniform(const std::string& name, const BareTexture& tex) {
-    int loc = getUniformLocation(name);
+    setUniformTexture(getUniform(name), tex);
+  }
 
-    if (loc == -1) {
-      return;
+  void Shader::setUniform(Id id, float val) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Float, &val, 1);
+  }
+
+  void Shader::setUniform(Id id, int val) {
+    setUniformInteger(getUniform(id, nullptr), val);
+  }
+
+  void Shader::setUniform(Id id, const Vector2f& vec) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Vec2, vec.data, 2);
+  }
+
+  void Shader::setUniform(Id id, const Vector3f& vec) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Vec3, vec.data, 3);
+  }
+
+  void Shader::setUniform(Id id, const Vector4f& vec) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Vec4, vec.data, 4);
+  }
+
+  void Shader::setUniform(Id id, const Matrix3f& mat) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Mat3, mat.data, 9);
+  }
+
+  void Shader::setUniform(Id id, const Matrix4f& mat) {
+    setUniformValues(getUniform(id, nullptr), UniformType::Mat4, mat.data, 16);
+  }
+
+  void Shader::setUniform(Id id, const BareTexture& tex) {
+    setUniformTexture(getUniform(id, nullptr), tex);
+  }
+
+  Shader::Uniform *Shader::getUniform(const std::string& name) {
+    auto it = m_uniformIndices.find(hash(name));
+
+    if (it == m_uniformIndices.end()) {
+      Log::warning(Log::Graphics, "Uniform not found: '%s'\n", name.c_str());
+      return nullptr;
     }
 
-    auto it = m_textures.find(loc);
+    return &m_uniforms[it->second];
+  }
 
-    if (it == m_textures.end()) {
-      m_textures.insert(std::make_pair(loc, &tex));
-    } else {
-      it->second = &tex;
+  Shader::Uniform *Shader::getUniform(Id id, const char *name) {
+    auto it = m_uniformIndices.find(id);
+
+    if (it == m_uniformIndices.end()) {
+      if (name != nullptr) {
+        Log::warning(Log::Graphics, "Uniform not found: '%s'\n", name);
+      } else {
+        Log::warning(Log::Graphics, "Uniform not found: #%llx\n", static_cast<unsigned long long>(id));
+      }
+
+      return nullptr;
     }
 
+    return &m_uniforms[it->second];
   }
 
-  int Shader::getUniformLocation(const std::string& name) {
-    GLint loc;
-    glCheck(loc = glGetUniformLocation(static_cast<GLuint>(m_program), name.c_str()));
+  static int findLocation(const std::map<Id, int>& locations, Id id) {
+    auto it = locations.find(id);
 
-    if (loc == -1) {
-      Log::warning(Log::Graphics, "Uniform not found: '%s'\n", name.c_str());
+    if (it == locations.end()) {
+      return -1;
     }
 
-    return loc;
+    return it->second;
   }
 
   int Shader::getAttributeLocation(const std::string& name) {
-    GLint loc;
-    glCheck(loc = glGetAttribLocation(static_cast<GLuint>(m_program), name.c_str()));
+    int loc = findLocation(m_attributes, hash(name));
 
     if (loc == -1) {
       Log::warning(Log::Graphics, "Attribute not found: '%s'\n", name.c_str());
@@ -326,21 +483,76 @@ inline namespace v1 {
     return loc;
   }
 
+  int Shader::getAttributeLocation(Id id, const char *name) {
+    int loc = findLocation(m_attributes, id);
+
+    if (loc == -1) {
+      Log::warning(Log::Graphics, "Attribute not found: '%s'\n", name);
+    }
+
+    return loc;
+  }
+
+  void Shader::uploadUniforms() const {
+    if (!m_dirty) {
+      return;
+    }
+
+    for (auto& uniform : m_uniforms) {
+      if (!uniform.dirty) {
+        continue;
+      }
+
+      switch (uniform.type) {
+        case UniformType::None:
+          break;
+        case UniformType::Float:
+          glCheck(glUniform1f(uniform.location, uniform.values[0]));
+          break;
+        case UniformType::Int:
+          glCheck(glUniform1i(uniform.location, uniform.integer));
+          break;
+        case UniformType::Vec2:
+          glCheck(glUniform2fv(uniform.location, 1, uniform.values));
+          break;
+        case UniformType::Vec3:
+          glCheck(glUniform3fv(uniform.location, 1, uniform.values));
+          break;
+        case UniformType::Vec4:
+          glCheck(glUniform4fv(uniform.location, 1, uniform.values));
+          break;
+        case UniformType::Mat3:
+          glCheck(glUniformMatrix3fv(uniform.location, 1, GL_FALSE, uniform.values));
+          break;
+        case UniformType::Mat4:
+          glCheck(glUniformMatrix4fv(uniform.location, 1, GL_FALSE, uniform.values));
+          break;
+      }
+
+      uniform.dirty = false;
+    }
+
+    m_dirty = false;
+  }
+
   void Shader::bind(const Shader *shader) {
+    priv::StateCache& cache = priv::getStateCache();
+
     if (shader && shader->m_program != 0) {
-      glCheck(glUseProgram(static_cast<GLuint>(shader->m_program)));
+      cache.useProgram(static_cast<GLuint>(shader->m_program));
+
+      // send the uniforms that have changed
+      shader->uploadUniforms();
 
       // bind textures
-      GLint index = 0;
-      for (auto& item : shader->m_textures) {
-        glCheck(glActiveTexture(GL_TEXTURE0 + index));
-        glCheck(glUniform1i(item.first, index));
-        BareTexture::bind(item.second);
-        index++;
+      for (auto& uniform : shader->m_uniforms) {
+        if (uniform.unit >= 0 && uniform.texture != nullptr) {
+          cache.bindTexture(uniform.unit, uniform.texture->getName());
+        }
       }
 
     } else {
-      glCheck(glUseProgram(0));
+      cache.useProgram(0);
     }
   }
 
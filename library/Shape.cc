@@ -28,6 +28,7 @@
 #include <gf/Color.h>
 #include <gf/RenderTarget.h>
 #include <gf/Texture.h>
+#include <gf/Transform.h>
 
 namespace gf {
 inline namespace v1 {
@@ -131,15 +132,28 @@ inline namespace v1 {
   }
 
   void Shape::updateTexCoords() {
-    for (std::size_t i = 0; i < m_vertices.getVertexCount(); ++i) {
-      Vector2f ratio(0.0f, 0.0f);
+    std::size_t count = m_vertices.getVertexCount();
 
-      if (!m_bounds.isEmpty()) {
-        ratio = (m_vertices[i].position - m_bounds.position) / m_bounds.size;
-      }
+    if (count == 0) {
+      return;
+    }
+
+    // texCoords = textureRect.position + textureRect.size * (position - bounds.position) / bounds.size
+    Vector2f factor(0.0f, 0.0f);
 
-      m_vertices[i].texCoords = m_textureRect.position + m_textureRect.size * ratio;
+    if (!m_bounds.isEmpty()) {
+      factor = m_textureRect.size / m_bounds.size;
     }
+
+    Vector2f offset = m_textureRect.position - m_bounds.position * factor;
+
+    Matrix3f mat{
+      factor.x,     0.0f, offset.x,
+          0.0f, factor.y, offset.y,
+          0.0f,     0.0f, 1.0f
+    };
+
+    gf::transform(mat, &m_vertices[0].position, sizeof(Vertex), &m_vertices[0].texCoords, sizeof(Vertex), count);
   }
 
   void Shape::updateOutline() {
@@ -187,15 +201,23 @@ inline namespace v1 {
 
   VertexBuffer Shape::commitGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+    commitGeometry(buffer);
     return buffer;
   }
 
+  void Shape::commitGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+  }
+
   VertexBuffer Shape::commitOutlineGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+    commitOutlineGeometry(buffer);
     return buffer;
   }
 
+  void Shape::commitOutlineGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+  }
+
 }
 }
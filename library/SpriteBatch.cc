@@ -20,23 +20,60 @@
  */
 #include <gf/SpriteBatch.h>
 
+#include <cstring>
+#include <algorithm>
+
+#include <gf/Color.h>
 #include <gf/RenderTarget.h>
 #include <gf/Sprite.h>
 #include <gf/Transform.h>
 #include <gf/Texture.h>
 
+#include "priv/RadixSort.h"
+#include "priv/ThreadPool.h"
+
 namespace gf {
 inline namespace v1 {
 
   SpriteBatch::SpriteBatch(RenderTarget& target)
   : m_target(target)
+  , m_mode(SortMode::Immediate)
   , m_count(0)
+  , m_multiTextured(false)
+  , m_lastStates(0)
+  , m_culling(false)
+  , m_culledCount(0)
+  , m_viewTransform(identity<Matrix3f>())
   {
 
   }
 
-  void SpriteBatch::begin() {
+  void SpriteBatch::setMultiTextured(bool multiTextured) {
+    m_multiTextured = multiTextured;
+
+    if (m_multiTextured) {
+      m_batchVertices.resize(MaxVertexCount);
+    } else {
+      m_batchVertices.clear();
+      m_batchVertices.shrink_to_fit();
+    }
+  }
+
+  void SpriteBatch::begin(SortMode mode) {
+    m_mode = mode;
     m_count = 0;
+
+    m_deferredSprites.clear();
+    m_deferredStates.clear();
+    m_lastStates = 0;
+    m_deferredTextures.clear();
+    m_items.clear();
+
+    m_culledCount = 0;
+
+    if (m_culling) {
+      m_viewTransform = m_target.getView().getTransform();
+    }
   }
 
   static bool areStatesSimilar(const RenderStates& lhs, const RenderStates& rhs) {
@@ -44,10 +81,226 @@ inline namespace v1 {
   }
 
   void SpriteBatch::draw(Sprite& sprite, const RenderStates& states) {
+    draw(sprite, 0.0f, states);
+  }
+
+  static uint64_t computeDepthKey(float depth) {
+    // map the float to an unsigned integer with the same order
+    uint32_t bits;
+    static_assert(sizeof bits == sizeof depth, "Unexpected float size");
+    std::memcpy(&bits, &depth, sizeof bits);
+
+    if ((bits & 0x80000000) != 0) {
+      bits = ~bits;
+    } else {
+      bits |= 0x80000000;
+    }
+
+    return bits;
+  }
+
+  static Vector2f computeSpriteSize(const Texture *texture, const RectF& textureRect) {
+    Vector2u textureSize = texture->getSize();
+    return textureSize * textureRect.size;
+  }
+
+  static void computeVertices(const Texture *texture, const RectF& textureRect, const Matrix3f& transform, const Color4f& color, PackedVertex *vertices) {
+    // compute sprite position
+
+    Vector2f spriteSize = computeSpriteSize(texture, textureRect);
+
+    // apply transform as it is different for every sprite
+    gf::expandQuads(&transform, &spriteSize, &vertices[0].position, sizeof(PackedVertex), 1);
+
+    // set sprite color
+
+    vertices[0].color = vertices[1].color = vertices[2].color = vertices[3].color = Color::toRgba32(color);
+
+    // compute sprite texture coordinates
+
+    vertices[0].texCoords = textureRect.getTopLeft();
+    vertices[1].texCoords = textureRect.getTopRight();
+    vertices[2].texCoords = textureRect.getBottomLeft();
+    vertices[3].texCoords = textureRect.getBottomRight();
+  }
+
+  /*
+   * The view transformation maps the visible area to the square [-1, 1]^2,
+   * whatever the rotation of the view. The local bounds of the sprite are
+   * mapped in this space and their bounding box is tested against the
+   * square. The test is conservative: a rotated sprite near a corner of
+   * the view may be kept even if it is not visible.
+   */
+
+  static bool isInsideView(const Matrix3f& mat, Vector2f size) {
+    // the images of the origin and of the two sides of the sprite
+    float x = mat.grid[0][2];
+    float y = mat.grid[1][2];
+    Vector2f side0(mat.grid[0][0] * size.width, mat.grid[1][0] * size.width);
+    Vector2f side1(mat.grid[0][1] * size.height, mat.grid[1][1] * size.height);
+
+    float minX = x + std::min(side0.x, 0.0f) + std::min(side1.x, 0.0f);
+    float maxX = x + std::max(side0.x, 0.0f) + std::max(side1.x, 0.0f);
+    float minY = y + std::min(side0.y, 0.0f) + std::min(side1.y, 0.0f);
+    float maxY = y + std::max(side0.y, 0.0f) + std::max(side1.y, 0.0f);
+
+    return maxX >= -1.0f && minX <= 1.0f && maxY >= -1.0f && minY <= 1.0f;
+  }
+
+  bool SpriteBatch::isVisible(const Matrix3f& transform, const Texture *texture, const RectF& textureRect, const RenderStates& states) {
+    if (!m_culling) {
+      return true;
+    }
+
+    if (isInsideView(m_viewTransform * states.transform * transform, computeSpriteSize(texture, textureRect))) {
+      return true;
+    }
+
+    m_culledCount++;
+    return false;
+  }
+
+  void SpriteBatch::draw(Sprite& sprite, float depth, const RenderStates& states) {
     const Texture *texture = sprite.getTexture();
-    RectF textureRect = sprite.getTextureRect();
-    Matrix3f transform = sprite.getTransform();
-    Color4f color = sprite.getColor();
+
+    if (!isVisible(sprite.getTransform(), texture, sprite.getTextureRect(), states)) {
+      return;
+    }
+
+    PackedVertex vertices[4];
+    computeVertices(texture, sprite.getTextureRect(), sprite.getTransform(), sprite.getColor(), vertices);
+
+    if (isDeferred()) {
+      addDeferredQuad(vertices, texture, depth, states);
+    } else {
+      addQuad(vertices, texture, states);
+    }
+  }
+
+  /*
+   * The vertices of the instances are computed in parallel, each thread
+   * writes a disjoint slice of the buffer. Then the quads are added in
+   * order on the calling thread, exactly like successive calls to draw().
+   */
+
+  static constexpr std::size_t InstanceGrain = 1024;
+
+  void SpriteBatch::draw(const SpriteInstance *instances, std::size_t count, const RenderStates& states) {
+    if (instances == nullptr || count == 0) {
+      return;
+    }
+
+    m_instanceVertices.resize(count * VerticesPerSprite);
+    PackedVertex *vertices = m_instanceVertices.data();
+
+    m_instanceVisible.resize(count);
+    uint8_t *visible = m_instanceVisible.data();
+
+    bool culling = m_culling;
+    Matrix3f viewTransform = m_viewTransform * states.transform;
+
+    priv::getThreadPool().parallelFor(count, InstanceGrain, [instances, vertices, visible, culling, &viewTransform](std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        const SpriteInstance& instance = instances[i];
+
+        if (culling && !isInsideView(viewTransform * instance.transform, computeSpriteSize(instance.texture, instance.textureRect))) {
+          visible[i] = 0;
+          continue;
+        }
+
+        visible[i] = 1;
+        computeVertices(instance.texture, instance.textureRect, instance.transform, instance.color, vertices + i * VerticesPerSprite);
+      }
+    });
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!visible[i]) {
+        m_culledCount++;
+        continue;
+      }
+
+      if (isDeferred()) {
+        addDeferredQuad(vertices + i * VerticesPerSprite, instances[i].texture, instances[i].depth, states);
+      } else {
+        addQuad(vertices + i * VerticesPerSprite, instances[i].texture, states);
+      }
+    }
+  }
+
+  void SpriteBatch::addDeferredQuad(const PackedVertex *vertices, const Texture *texture, float depth, const RenderStates& states) {
+    DeferredSprite deferred;
+    std::copy_n(vertices, VerticesPerSprite, deferred.vertices.begin());
+    deferred.texture = texture;
+    deferred.states = getStatesIndex(states);
+
+    uint64_t key = 0;
+
+    if (hasMode(SortMode::Texture)) {
+      // the indices only group the sprites, a collision can not break the rendering
+      key |= static_cast<uint64_t>(deferred.states & 0xFFFF) << 16;
+      key |= static_cast<uint64_t>(getTextureIndex(texture) & 0xFFFF);
+    }
+
+    if (hasMode(SortMode::BackToFront)) {
+      key |= (~computeDepthKey(depth) & 0xFFFFFFFF) << 32;
+    } else if (hasMode(SortMode::FrontToBack)) {
+      key |= computeDepthKey(depth) << 32;
+    }
+
+    m_items.push_back({ key, static_cast<uint32_t>(m_deferredSprites.size()) });
+    m_deferredSprites.push_back(deferred);
+  }
+
+  void SpriteBatch::end() {
+    if (isDeferred()) {
+      renderDeferred();
+    }
+
+    renderBatch();
+  }
+
+  bool SpriteBatch::isDeferred() const {
+    return m_mode != SortMode::Immediate;
+  }
+
+  bool SpriteBatch::hasMode(SortMode mode) const {
+    return (static_cast<unsigned>(m_mode) & static_cast<unsigned>(mode)) != 0;
+  }
+
+  std::size_t SpriteBatch::getStatesIndex(const RenderStates& states) {
+    if (m_lastStates < m_deferredStates.size() && areStatesSimilar(m_deferredStates[m_lastStates], states)) {
+      return m_lastStates;
+    }
+
+    for (std::size_t i = 0; i < m_deferredStates.size(); ++i) {
+      if (areStatesSimilar(m_deferredStates[i], states)) {
+        m_lastStates = i;
+        return i;
+      }
+    }
+
+    m_lastStates = m_deferredStates.size();
+    m_deferredStates.push_back(states);
+    return m_lastStates;
+  }
+
+  std::size_t SpriteBatch::getTextureIndex(const Texture *texture) {
+    auto it = m_deferredTextures.find(texture);
+
+    if (it != m_deferredTextures.end()) {
+      return it->second;
+    }
+
+    std::size_t index = m_deferredTextures.size();
+    m_deferredTextures.insert(std::make_pair(texture, index));
+    return index;
+  }
+
+  void SpriteBatch::addQuad(const PackedVertex *vertices, const Texture *texture, const RenderStates& states) {
+    if (m_multiTextured) {
+      addBatchQuad(vertices, texture, states);
+      return;
+    }
 
     if (m_count == 0) {
       m_currentRenderStates.mode = states.mode;
@@ -65,53 +318,69 @@ inline namespace v1 {
       }
     }
 
-    Vertex vertices[4];
+    // add the quad
 
-    // compute sprite position
+    std::size_t index = m_count * VerticesPerSprite;
+    std::copy_n(vertices, VerticesPerSprite, m_vertices.begin() + index);
 
-    Vector2u textureSize = texture->getSize();
-    Vector2f spriteSize = textureSize * textureRect.size;
+    m_count++;
+  }
 
-    vertices[0].position = {  0.0f,            0.0f };
-    vertices[1].position = { spriteSize.width, 0.0f };
-    vertices[2].position = {  0.0f,            spriteSize.height };
-    vertices[3].position = { spriteSize.width, spriteSize.height };
+  void SpriteBatch::addBatchQuad(const PackedVertex *vertices, const Texture *texture, const RenderStates& states) {
+    auto it = std::find(m_textureSlots.begin(), m_textureSlots.end(), texture);
+    bool slotsFull = m_textureSlots.size() >= m_target.getTextureSlotCount();
 
-    for (auto& vertex : vertices) {
-      // apply transform as it is different for every sprite
-      vertex.position = gf::transform(transform, vertex.position);
+    if (m_count > 0) {
+      if (m_count == MaxSpriteCount || (it == m_textureSlots.end() && slotsFull) || !areStatesSimilar(m_currentRenderStates, states)) {
+        renderBatch();
+        it = m_textureSlots.end();
+      }
     }
 
-    // set sprite color
+    if (m_count == 0) {
+      m_currentRenderStates.mode = states.mode;
+      m_currentRenderStates.transform = states.transform;
+      m_currentRenderStates.texture = nullptr;
+      m_currentRenderStates.shader = states.shader;
+    }
 
-    vertices[0].color = vertices[1].color = vertices[2].color = vertices[3].color = color;
+    if (it == m_textureSlots.end()) {
+      it = m_textureSlots.insert(m_textureSlots.end(), texture);
+    }
 
-    // compute sprite texture coordinates
+    float slot = static_cast<float>(it - m_textureSlots.begin());
 
-    vertices[0].texCoords = textureRect.getTopLeft();
-    vertices[1].texCoords = textureRect.getTopRight();
-    vertices[2].texCoords = textureRect.getBottomLeft();
-    vertices[3].texCoords = textureRect.getBottomRight();
-
-    // add first triangle
+    // add the quad
 
     std::size_t index = m_count * VerticesPerSprite;
 
-    m_vertices[index + 0] = vertices[0];
-    m_vertices[index + 1] = vertices[1];
-    m_vertices[index + 2] = vertices[2];
-
-    // add second triangle
-
-    m_vertices[index + 3] = vertices[2];
-    m_vertices[index + 4] = vertices[1];
-    m_vertices[index + 5] = vertices[3];
+    for (std::size_t i = 0; i < VerticesPerSprite; ++i) {
+      BatchVertex& vertex = m_batchVertices[index + i];
+      vertex.position = vertices[i].position;
+      vertex.color = vertices[i].color;
+      vertex.texCoords = vertices[i].texCoords;
+      vertex.textureSlot = slot;
+    }
 
     m_count++;
   }
 
-  void SpriteBatch::end() {
-    renderBatch();
+
+  void SpriteBatch::renderDeferred() {
+    if (hasMode(SortMode::Texture) || hasMode(SortMode::BackToFront) || hasMode(SortMode::FrontToBack)) {
+      priv::radixSort(m_items, m_sortBuffer);
+    }
+
+    for (auto& item : m_items) {
+      const DeferredSprite& sprite = m_deferredSprites[item.index];
+      addQuad(sprite.vertices.data(), sprite.texture, m_deferredStates[sprite.states]);
+    }
+
+    m_deferredSprites.clear();
+    m_deferredStates.clear();
+    m_lastStates = 0;
+    m_deferredTextures.clear();
+    m_items.clear();
   }
 
   void SpriteBatch::renderBatch() {
@@ -121,7 +390,13 @@ inline namespace v1 {
 
     // Log::debug(Log::Graphics, "Batch %zu sprites...\n", m_count);
 
-    m_target.draw(m_vertices.data(), m_count * VerticesPerSprite, PrimitiveType::Triangles, m_currentRenderStates);
+    if (m_multiTextured) {
+      m_target.draw(m_batchVertices.data(), m_count * VerticesPerSprite, PrimitiveType::Quads, m_textureSlots.data(), m_textureSlots.size(), m_currentRenderStates);
+      m_textureSlots.clear();
+    } else {
+      m_target.draw(m_vertices.data(), m_count * VerticesPerSprite, PrimitiveType::Quads, m_currentRenderStates);
+    }
+
     m_count = 0;
   }
 
@@ -38,11 +38,11 @@ inline namespace v1 {
   , m_font(nullptr)
   , m_characterSize(0)
   , m_color(gf::Color::Black)
-  , m_vertices(PrimitiveType::Triangles)
+  , m_vertices(PrimitiveType::Quads)
   , m_bounds(0.0f, 0.0f, 0.0f, 0.0f)
   , m_outlineColor(gf::Color::Black)
   , m_outlineThickness(0.0f)
-  , m_outlineVertices(PrimitiveType::Triangles)
+  , m_outlineVertices(PrimitiveType::Quads)
   , m_paragraphWidth(0.0f)
   , m_align(Alignment::None)
   {
@@ -54,11 +54,11 @@ inline namespace v1 {
   , m_font(&font)
   , m_characterSize(characterSize)
   , m_color(gf::Color::Black)
-  , m_vertices(PrimitiveType::Triangles)
+  , m_vertices(PrimitiveType::Quads)
   , m_bounds(0.0f, 0.0f, 0.0f, 0.0f)
   , m_outlineColor(gf::Color::Black)
   , m_outlineThickness(0.0f)
-  , m_outlineVertices(PrimitiveType::Triangles)
+  , m_outlineVertices(PrimitiveType::Quads)
   , m_paragraphWidth(0.0f)
   , m_align(Alignment::None)
   {
@@ -98,7 +98,7 @@ inline namespace v1 {
     auto count = m_vertices.getVertexCount();
 
     for (std::size_t i = 0; i < count; ++i) {
-      m_vertices[i].color = color;
+      m_vertices[i].color = Color::toRgba32(color);
     }
   }
 
@@ -108,7 +108,7 @@ inline namespace v1 {
     auto count = m_outlineVertices.getVertexCount();
 
     for (std::size_t i = 0; i < count; ++i) {
-      m_outlineVertices[i].color = color;
+      m_outlineVertices[i].color = Color::toRgba32(color);
     }
   }
 
@@ -145,16 +145,24 @@ inline namespace v1 {
 
   VertexBuffer Text::commitGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+    commitGeometry(buffer);
     return buffer;
   }
 
+  void Text::commitGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_vertices.getVertexData(), m_vertices.getVertexCount(), m_vertices.getPrimitiveType());
+  }
+
   VertexBuffer Text::commitOutlineGeometry() const {
     VertexBuffer buffer;
-    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+    commitOutlineGeometry(buffer);
     return buffer;
   }
 
+  void Text::commitOutlineGeometry(VertexBuffer& buffer) const {
+    buffer.load(m_outlineVertices.getVertexData(), m_outlineVertices.getVertexCount(), m_outlineVertices.getPrimitiveType());
+  }
+
   void Text::draw(RenderTarget& target, RenderStates states) {
     if (m_font == nullptr || m_characterSize == 0) {
       return;
@@ -170,8 +178,8 @@ inline namespace v1 {
     target.draw(m_vertices, states);
   }
 
-  static void addGlyphVertex(VertexArray& array, const Glyph& glyph, const Vector2f& position, const Color4f& color) {
-    Vertex vertices[4];
+  static void addGlyphVertex(PackedVertexArray& array, const Glyph& glyph, const Vector2f& position, const Color4u& color) {
+    PackedVertex vertices[4];
 
     vertices[0].position = position + glyph.bounds.getTopLeft();
     vertices[1].position = position + glyph.bounds.getTopRight();
@@ -185,14 +193,9 @@ inline namespace v1 {
     vertices[2].texCoords = glyph.textureRect.getBottomLeft();
     vertices[3].texCoords = glyph.textureRect.getBottomRight();
 
-    // first triangle
     array.append(vertices[0]);
     array.append(vertices[1]);
     array.append(vertices[2]);
-
-    // second triangle
-    array.append(vertices[2]);
-    array.append(vertices[1]);
     array.append(vertices[3]);
   }
 
@@ -210,6 +213,9 @@ inline namespace v1 {
 
     std::vector<Paragraph> paragraphs = makeParagraphs(m_string, spaceWidth);
 
+    Color4u color = Color::toRgba32(m_color);
+    Color4u outlineColor = Color::toRgba32(m_outlineColor);
+
     Vector2f position(0.0f, 0.0f);
 
     Vector2f min(0.0f, 0.0f);
@@ -236,7 +242,7 @@ inline namespace v1 {
             if (m_outlineThickness > 0) {
               const Glyph& glyph = m_font->getGlyph(currCodepoint, m_characterSize, m_outlineThickness);
 
-              addGlyphVertex(m_outlineVertices, glyph, position, m_outlineColor);
+              addGlyphVertex(m_outlineVertices, glyph, position, outlineColor);
 
               min = gf::min(min, position + glyph.bounds.getTopLeft());
               max = gf::max(max, position + glyph.bounds.getBottomRight());
@@ -244,7 +250,7 @@ inline namespace v1 {
 
             const Glyph& glyph = m_font->getGlyph(currCodepoint, m_characterSize);
 
-            addGlyphVertex(m_vertices, glyph, position, m_color);
+            addGlyphVertex(m_vertices, glyph, position, color);
 
             if (m_outlineThickness == 0.0f) {
               min = gf::min(min, position + glyph.bounds.getTopLeft());
@@ -24,12 +24,20 @@
 #include <gf/Texture.h>
 
 #include <cassert>
+#include <cctype>
+#include <algorithm>
+#include <vector>
 
 #include <glad/glad.h>
 
 #include <gf/Image.h>
+#include <gf/InputStreams.h>
+#include <gf/Log.h>
 
+#include "priv/CompressedImage.h"
 #include "priv/Debug.h"
+#include "priv/RenderCounters.h"
+#include "priv/StateCache.h"
 
 namespace gf {
 inline namespace v1 {
@@ -40,15 +48,29 @@ inline namespace v1 {
   , m_size{0, 0}
   , m_smooth(false)
   , m_repeated(false)
+  , m_mipmap(false)
+  , m_compressed(false)
+  , m_streaming(false)
+  , m_uploadFence(nullptr)
   {
 
   }
 
+  static constexpr std::size_t StreamTextureCount = 3;
+
+  static void deleteTexture(unsigned name) {
+    GLuint glName = static_cast<GLuint>(name);
+    priv::getStateCache().forgetTexture(glName);
+    glCheck(glDeleteTextures(1, &glName));
+  }
+
   BareTexture::~BareTexture() {
     if (m_name != 0) {
-      GLuint name = static_cast<GLuint>(m_name);
-      glCheck(glDeleteTextures(1, &name));
+      deleteTexture(m_name);
     }
+
+    releaseStreamNames();
+    releaseUploadFence();
   }
 
   BareTexture::BareTexture(BareTexture&& other)
@@ -57,8 +79,15 @@ inline namespace v1 {
   , m_size(other.m_size)
   , m_smooth(other.m_smooth)
   , m_repeated(other.m_repeated)
+  , m_mipmap(other.m_mipmap)
+  , m_compressed(other.m_compressed)
+  , m_streaming(other.m_streaming)
+  , m_streamNames(std::move(other.m_streamNames))
+  , m_uploadFence(other.m_uploadFence)
   {
     other.m_name = 0;
+    other.m_streamNames.clear();
+    other.m_uploadFence = nullptr;
   }
 
   BareTexture& BareTexture::operator=(BareTexture&& other) {
@@ -67,6 +96,11 @@ inline namespace v1 {
     std::swap(m_size, other.m_size);
     std::swap(m_smooth, other.m_smooth);
     std::swap(m_repeated, other.m_repeated);
+    std::swap(m_mipmap, other.m_mipmap);
+    std::swap(m_compressed, other.m_compressed);
+    std::swap(m_streaming, other.m_streaming);
+    std::swap(m_streamNames, other.m_streamNames);
+    std::swap(m_uploadFence, other.m_uploadFence);
     return *this;
   }
 
@@ -94,6 +128,31 @@ inline namespace v1 {
     return 4;
   };
 
+  static GLint getMinFilter(bool smooth, bool mipmap) {
+    if (mipmap) {
+      return smooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+    }
+
+    return smooth ? GL_LINEAR : GL_NEAREST;
+  }
+
+  // on the bound texture
+  static void setParameters(bool smooth, bool repeated, bool mipmap) {
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, smooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(smooth, mipmap)));
+  }
+
+  static bool isPowerOfTwo(unsigned value) {
+    return value != 0 && (value & (value - 1)) == 0;
+  }
+
+  // without GL_OES_texture_npot, the mipmaps need a power of two size
+  static bool canHaveMipmap(Vector2u size) {
+    return GLAD_GL_OES_texture_npot || (isPowerOfTwo(size.width) && isPowerOfTwo(size.height));
+  }
+
   bool BareTexture::create(Vector2u size, const uint8_t *data) {
     if (size.width == 0 || size.height == 0) {
       return false;
@@ -105,18 +164,27 @@ inline namespace v1 {
       m_name = static_cast<unsigned>(name);
     }
 
+    if (size != m_size) {
+      // the textures of the ring have the previous size
+      releaseStreamNames();
+    }
+
     m_size = size;
+    m_mipmap = false;
+    m_compressed = false;
 
     GLenum textureFormat = getEnum(m_format);
 
     glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, getAlignment(m_format)));
 
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_name));
+    priv::getStateCache().bindTexture(m_name);
     glCheck(glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, m_size.width, m_size.height, 0, textureFormat, GL_UNSIGNED_BYTE, data));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+    ++priv::getRenderCounters().textureUploads;
+    setParameters(m_smooth, m_repeated, m_mipmap);
+
+    if (data != nullptr) {
+      setUploadFence();
+    }
 
     return true;
   }
@@ -132,9 +200,15 @@ inline namespace v1 {
       return;
     }
 
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_name));
+    priv::getStateCache().bindTexture(m_name);
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_smooth, m_mipmap)));
+
+    for (unsigned name : m_streamNames) {
+      priv::getStateCache().bindTexture(name);
+      glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+      glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+    }
   }
 
   void BareTexture::setRepeated(bool repeated) {
@@ -148,9 +222,47 @@ inline namespace v1 {
       return;
     }
 
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_name));
+    priv::getStateCache().bindTexture(m_name);
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+
+    for (unsigned name : m_streamNames) {
+      priv::getStateCache().bindTexture(name);
+      glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+      glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    }
+  }
+
+  bool BareTexture::generateMipmap() {
+    if (m_name == 0) {
+      return false;
+    }
+
+    if (m_compressed) {
+      Log::warning(Log::Graphics, "Could not generate the mipmap of a compressed texture.\n");
+      return false;
+    }
+
+    if (!canHaveMipmap(m_size)) {
+      Log::warning(Log::Graphics, "Could not generate the mipmap of a texture whose size is not a power of two.\n");
+      return false;
+    }
+
+    priv::getStateCache().bindTexture(m_name);
+    glCheck(glGenerateMipmap(GL_TEXTURE_2D));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_smooth, true)));
+    m_mipmap = true;
+    return true;
+  }
+
+  void BareTexture::invalidateMipmap() {
+    if (!m_mipmap) {
+      return;
+    }
+
+    priv::getStateCache().bindTexture(m_name);
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_smooth, false)));
+    m_mipmap = false;
   }
 
   void BareTexture::update(const uint8_t *data) {
@@ -165,11 +277,181 @@ inline namespace v1 {
       return;
     }
 
+    if (m_compressed) {
+      Log::warning(Log::Graphics, "Could not update a compressed texture.\n");
+      return;
+    }
+
+    invalidateMipmap();
 
     glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, getAlignment(m_format)));
 
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_name));
+    if (m_streaming && rect.width == m_size.width && rect.height == m_size.height) {
+      // upload in the next texture of the ring, the previous images may still be in use
+      m_streamNames.push_back(m_name);
+
+      if (m_streamNames.size() < StreamTextureCount) {
+        GLuint name;
+        glCheck(glGenTextures(1, &name));
+        m_name = static_cast<unsigned>(name);
+
+        GLenum textureFormat = getEnum(m_format);
+
+        priv::getStateCache().bindTexture(m_name);
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, m_size.width, m_size.height, 0, textureFormat, GL_UNSIGNED_BYTE, data));
+        ++priv::getRenderCounters().textureUploads;
+        setParameters(m_smooth, m_repeated, m_mipmap);
+
+        setUploadFence();
+        return;
+      }
+
+      m_name = m_streamNames.front();
+      m_streamNames.erase(m_streamNames.begin());
+    }
+
+    priv::getStateCache().bindTexture(m_name);
     glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, rect.top, rect.width, rect.height, getEnum(m_format), GL_UNSIGNED_BYTE, data));
+    ++priv::getRenderCounters().textureUploads;
+
+    setUploadFence();
+  }
+
+  bool BareTexture::createFromCompressed(const uint8_t *data, std::size_t length) {
+    assert(m_format == Format::Color);
+
+    priv::CompressedImage image;
+
+    if (!priv::loadCompressedImage(data, length, image)) {
+      return false;
+    }
+
+    assert(!image.levels.empty());
+    const priv::CompressedLevel& base = image.levels.front();
+    GLenum format = image.format;
+    bool supported = priv::isCompressedFormatSupported(format);
+
+    if (!supported && format == priv::CompressedRgbEtc1 && priv::isCompressedFormatSupported(priv::CompressedRgbEtc2)) {
+      // ETC2 decoders are backward compatible with ETC1
+      format = priv::CompressedRgbEtc2;
+      supported = true;
+    }
+
+    if (!supported) {
+      Log::info(Log::Graphics, "Compressed format %s is not supported by the GPU, decoding on the CPU.\n", priv::getCompressedFormatName(image.format));
+
+      std::vector<uint8_t> pixels;
+
+      if (!priv::decodeCompressedLevel(image.format, base, pixels)) {
+        Log::error(Log::Graphics, "Could not decode compressed format %s.\n", priv::getCompressedFormatName(image.format));
+        return false;
+      }
+
+      if (!create(base.size, pixels.data())) {
+        return false;
+      }
+
+      if (image.levels.size() > 1) {
+        generateMipmap();
+      }
+
+      return true;
+    }
+
+    if (base.size.width == 0 || base.size.height == 0) {
+      return false;
+    }
+
+    // the mipmap levels are used only if the chain is complete
+    std::size_t completeCount = 1;
+    unsigned largest = std::max(base.size.width, base.size.height);
+
+    while (largest > 1) {
+      largest /= 2;
+      ++completeCount;
+    }
+
+    std::size_t levelCount = 1;
+
+    if (image.levels.size() >= completeCount && canHaveMipmap(base.size)) {
+      levelCount = completeCount;
+    }
+
+    if (m_name == 0) {
+      GLuint name;
+      glCheck(glGenTextures(1, &name));
+      m_name = static_cast<unsigned>(name);
+    }
+
+    releaseStreamNames();
+
+    m_size = base.size;
+    m_mipmap = (levelCount > 1);
+    m_compressed = true;
+
+    priv::getStateCache().bindTexture(m_name);
+
+    for (std::size_t i = 0; i < levelCount; ++i) {
+      const priv::CompressedLevel& level = image.levels[i];
+      glCheck(glCompressedTexImage2D(GL_TEXTURE_2D, i, format, level.size.width, level.size.height, 0, level.length, level.data));
+      ++priv::getRenderCounters().textureUploads;
+    }
+
+    setParameters(m_smooth, m_repeated, m_mipmap);
+    setUploadFence();
+    return true;
+  }
+
+  void BareTexture::setStreaming(bool streaming) {
+    m_streaming = streaming;
+
+    if (!m_streaming) {
+      releaseStreamNames();
+    }
+  }
+
+  bool BareTexture::isUploadComplete() {
+    if (m_uploadFence == nullptr) {
+      return true;
+    }
+
+    GLsync sync = static_cast<GLsync>(m_uploadFence);
+    GLenum status;
+    glCheck(status = glClientWaitSyncAPPLE(sync, GL_SYNC_FLUSH_COMMANDS_BIT_APPLE, 0));
+
+    if (status != GL_ALREADY_SIGNALED_APPLE && status != GL_CONDITION_SATISFIED_APPLE) {
+      return false;
+    }
+
+    releaseUploadFence();
+    return true;
+  }
+
+  void BareTexture::releaseStreamNames() {
+    for (unsigned name : m_streamNames) {
+      deleteTexture(name);
+    }
+
+    m_streamNames.clear();
+  }
+
+  void BareTexture::releaseUploadFence() {
+    if (m_uploadFence != nullptr) {
+      glCheck(glDeleteSyncAPPLE(static_cast<GLsync>(m_uploadFence)));
+      m_uploadFence = nullptr;
+    }
+  }
+
+  void BareTexture::setUploadFence() {
+    if (!GLAD_GL_APPLE_sync) {
+      return;
+    }
+
+    releaseUploadFence();
+
+    GLsync sync;
+    glCheck(sync = glFenceSyncAPPLE(GL_SYNC_GPU_COMMANDS_COMPLETE_APPLE, 0));
+    m_uploadFence = sync;
   }
 
   RectF BareTexture::computeTextureCoords(const RectU& rect) const {
@@ -183,9 +465,9 @@ inline namespace v1 {
 
   void BareTexture::bind(const BareTexture *texture) {
     if (texture && texture->m_name != 0) {
-      glCheck(glBindTexture(GL_TEXTURE_2D, texture->m_name));
+      priv::getStateCache().bindTexture(texture->m_name);
     } else {
-      glCheck(glBindTexture(GL_TEXTURE_2D, 0));
+      priv::getStateCache().bindTexture(0);
     }
   }
 
@@ -203,17 +485,48 @@ inline namespace v1 {
     return BareTexture::create(image.getSize(), image.getPixelsPtr());
   }
 
+  static bool hasCompressedExtension(const Path& filename) {
+    std::string extension = filename.extension().string();
+
+    for (auto& c : extension) {
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    return extension == ".ktx" || extension == ".dds";
+  }
+
   bool Texture::loadFromFile(const Path& filename) {
+    if (hasCompressedExtension(filename)) {
+      FileInputStream stream(filename);
+      return loadFromStream(stream);
+    }
+
     Image image;
     return image.loadFromFile(filename) && loadFromImage(image);
   }
 
   bool Texture::loadFromStream(InputStream& stream) {
+    // look at the magic of the data, and go back to the start
+    long start = stream.tell();
+    uint8_t magic[12];
+    std::size_t magicLength = stream.read(magic, sizeof magic);
+    stream.seek(start);
+
+    if (priv::isCompressedContainer(magic, magicLength)) {
+      std::vector<uint8_t> data(stream.getSize() - start);
+      std::size_t length = stream.read(data.data(), data.size());
+      return createFromCompressed(data.data(), length);
+    }
+
     Image image;
     return image.loadFromStream(stream) && loadFromImage(image);
   }
 
   bool Texture::loadFromMemory(const uint8_t *data, std::size_t length) {
+    if (priv::isCompressedContainer(data, length)) {
+      return createFromCompressed(data, length);
+    }
+
     Image image;
     return image.loadFromMemory(data, length) && loadFromImage(image);
   }
@@ -242,6 +555,7 @@ inline namespace v1 {
     glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &boundFrameBuffer));
 
     glCheck(glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer));
+    ++priv::getRenderCounters().framebufferSwitches;
     glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, getName(), 0));
     assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 
@@ -251,6 +565,7 @@ inline namespace v1 {
     glCheck(glDeleteFramebuffers(1, &frameBuffer));
 
     glCheck(glBindFramebuffer(GL_FRAMEBUFFER, boundFrameBuffer));
+    ++priv::getRenderCounters().framebufferSwitches;
 
     Image image;
     image.create(size, pixels.data());
@@ -22,6 +22,8 @@
 
 #include <cassert>
 #include <cstring>
+#include <fstream>
+#include <vector>
 
 #include <gf/Log.h>
 #include <gf/Texture.h>
@@ -31,9 +33,156 @@
 namespace gf {
 inline namespace v1 {
 
+  static constexpr char BinaryMagic[4] = { 'G', 'F', 'A', 'T' };
+  static constexpr uint32_t BinaryVersion = 1;
+
   bool TextureAtlas::loadFromFile(const Path& filename) {
+    // read the whole file at once
+    std::ifstream file(filename.string(), std::ios::binary | std::ios::ate);
+
+    if (!file) {
+      Log::error(Log::Resources, "Could not load atlas texture: '%s'\n", filename.string().c_str());
+      return false;
+    }
+
+    std::vector<char> content(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+
+    if (!file.read(content.data(), content.size())) {
+      Log::error(Log::Resources, "Could not read atlas texture: '%s'\n", filename.string().c_str());
+      return false;
+    }
+
+    if (content.size() >= sizeof BinaryMagic && std::memcmp(content.data(), BinaryMagic, sizeof BinaryMagic) == 0) {
+      return loadFromBinary(reinterpret_cast<const uint8_t *>(content.data()), content.size(), filename);
+    }
+
+    return loadFromXml(content.data(), content.size(), filename);
+  }
+
+  static void writeUint32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  static void writeString(std::vector<uint8_t>& out, const std::string& str) {
+    writeUint32(out, static_cast<uint32_t>(str.size()));
+    out.insert(out.end(), str.begin(), str.end());
+  }
+
+  bool TextureAtlas::saveToBinaryFile(const Path& filename) const {
+    std::vector<uint8_t> out(BinaryMagic, BinaryMagic + sizeof BinaryMagic);
+    writeUint32(out, BinaryVersion);
+    writeUint32(out, static_cast<uint32_t>(m_rects.size()));
+    writeString(out, m_texturePath.generic_string());
+
+    for (auto& entry : m_rects) {
+      writeString(out, entry.first);
+      writeUint32(out, entry.second.left);
+      writeUint32(out, entry.second.top);
+      writeUint32(out, entry.second.width);
+      writeUint32(out, entry.second.height);
+    }
+
+    std::ofstream file(filename.string(), std::ios::binary);
+
+    if (!file || !file.write(reinterpret_cast<const char *>(out.data()), out.size())) {
+      Log::error(Log::Resources, "Could not save atlas texture: '%s'\n", filename.string().c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+  namespace {
+
+    class BinaryReader {
+    public:
+      BinaryReader(const uint8_t *data, std::size_t length)
+      : m_data(data)
+      , m_length(length)
+      , m_error(false)
+      {
+
+      }
+
+      bool hasError() const {
+        return m_error;
+      }
+
+      uint32_t readUint32() {
+        if (m_length < 4) {
+          m_error = true;
+          return 0;
+        }
+
+        uint32_t value = uint32_t(m_data[0]) | (uint32_t(m_data[1]) << 8) | (uint32_t(m_data[2]) << 16) | (uint32_t(m_data[3]) << 24);
+        m_data += 4;
+        m_length -= 4;
+        return value;
+      }
+
+      std::string readString() {
+        uint32_t size = readUint32();
+
+        if (m_error || m_length < size) {
+          m_error = true;
+          return "";
+        }
+
+        std::string str(reinterpret_cast<const char *>(m_data), size);
+        m_data += size;
+        m_length -= size;
+        return str;
+      }
+
+    private:
+      const uint8_t *m_data;
+      std::size_t m_length;
+      bool m_error;
+    };
+
+  }
+
+  bool TextureAtlas::loadFromBinary(const uint8_t *data, std::size_t length, const Path& filename) {
+    BinaryReader reader(data + sizeof BinaryMagic, length - sizeof BinaryMagic);
+
+    if (reader.readUint32() != BinaryVersion) {
+      Log::error(Log::Resources, "Unknown version of binary atlas texture: '%s'\n", filename.string().c_str());
+      return false;
+    }
+
+    uint32_t count = reader.readUint32();
+    Path texturePath = reader.readString();
+
+    std::map<std::string, RectU> rects;
+
+    for (uint32_t i = 0; i < count && !reader.hasError(); ++i) {
+      std::string name = reader.readString();
+
+      RectU rect;
+      rect.left = reader.readUint32();
+      rect.top = reader.readUint32();
+      rect.width = reader.readUint32();
+      rect.height = reader.readUint32();
+
+      rects.emplace(std::move(name), rect);
+    }
+
+    if (reader.hasError() || texturePath.empty()) {
+      Log::error(Log::Resources, "Truncated binary atlas texture: '%s'\n", filename.string().c_str());
+      return false;
+    }
+
+    setTexturePath(texturePath);
+    m_rects.insert(rects.begin(), rects.end());
+    return true;
+  }
+
+  bool TextureAtlas::loadFromXml(const char *data, std::size_t length, const Path& filename) {
     tinyxml2::XMLDocument doc;
-    int err = doc.LoadFile(filename.string().c_str());
+    int err = doc.Parse(data, length);
 
     if (doc.Error()) {
       assert(err != tinyxml2::XML_SUCCESS);
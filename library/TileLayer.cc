@@ -39,7 +39,7 @@ inline namespace v1 {
   , m_spacing(0)
   , m_tiles(layerSize, NoTile)
   , m_rect(0, 0, 0, 0)
-  , m_vertices(PrimitiveType::Triangles)
+  , m_vertices(PrimitiveType::Quads)
   {
 
   }
@@ -117,7 +117,7 @@ inline namespace v1 {
       return;
     }
 
-    m_vertices.reserve(m_rect.height * m_rect.width * 6);
+    m_vertices.reserve(m_rect.height * m_rect.width * 4);
 
     Vector2u tilesetSize = (m_texture->getSize() - 2 * m_margin + m_spacing) / (m_tileSize + m_spacing);
 
@@ -160,16 +160,11 @@ inline namespace v1 {
         vertices[2].texCoords = textureCoords.getBottomLeft();
         vertices[3].texCoords = textureCoords.getBottomRight();
 
-        // first triangle
+        // quad
 
         m_vertices.append(vertices[0]);
         m_vertices.append(vertices[1]);
         m_vertices.append(vertices[2]);
-
-        // second triangle
-
-        m_vertices.append(vertices[2]);
-        m_vertices.append(vertices[1]);
         m_vertices.append(vertices[3]);
       }
     }
@@ -20,9 +20,20 @@
  */
 #include <gf/Transform.h>
 
+#include <cstdint>
 #include <algorithm>
 #include <tuple>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GF_TRANSFORM_SSE2
+#endif
+
+#if defined(GF_TRANSFORM_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GF_TRANSFORM_AVX
+#endif
+
 #include <gf/Matrix.h>
 #include <gf/Rect.h>
 
@@ -44,6 +55,162 @@ inline namespace v1 {
     return RectF(min, max - min);
   }
 
+  /*
+   * Batch transformations
+   *
+   * The SIMD versions compute (m0 * x + m1 * y) + m2 like the scalar
+   * version, so that the results are exactly the same. The points are
+   * accessed through byte pointers because of the strides.
+   */
+
+  static inline const Vector2f& pointAt(const Vector2f *points, std::size_t stride, std::size_t i) {
+    return *reinterpret_cast<const Vector2f *>(reinterpret_cast<const uint8_t *>(points) + i * stride);
+  }
+
+  static inline Vector2f& pointAt(Vector2f *points, std::size_t stride, std::size_t i) {
+    return *reinterpret_cast<Vector2f *>(reinterpret_cast<uint8_t *>(points) + i * stride);
+  }
+
+#ifdef GF_TRANSFORM_SSE2
+  static inline __m128 loadPoints(const Vector2f& p0, const Vector2f& p1) {
+    __m128 points = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(p0.data));
+    return _mm_loadh_pi(points, reinterpret_cast<const __m64 *>(p1.data));
+  }
+
+  static inline void storePoints(__m128 points, Vector2f& p0, Vector2f& p1) {
+    _mm_storel_pi(reinterpret_cast<__m64 *>(p0.data), points);
+    _mm_storeh_pi(reinterpret_cast<__m64 *>(p1.data), points);
+  }
+#endif
+
+#ifdef GF_TRANSFORM_AVX
+  static bool hasAvx() {
+    static const bool avx = __builtin_cpu_supports("avx");
+    return avx;
+  }
+
+  __attribute__((target("avx")))
+  static std::size_t transformAvx(const Matrix3f& mat, const Vector2f *points, Vector2f *result, std::size_t count) {
+    const __m256 cx = _mm256_setr_ps(mat.data[0], mat.data[3], mat.data[0], mat.data[3], mat.data[0], mat.data[3], mat.data[0], mat.data[3]);
+    const __m256 cy = _mm256_setr_ps(mat.data[1], mat.data[4], mat.data[1], mat.data[4], mat.data[1], mat.data[4], mat.data[1], mat.data[4]);
+    const __m256 ct = _mm256_setr_ps(mat.data[2], mat.data[5], mat.data[2], mat.data[5], mat.data[2], mat.data[5], mat.data[2], mat.data[5]);
+
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+      __m256 p = _mm256_loadu_ps(points[i].data);
+      __m256 xs = _mm256_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+      __m256 ys = _mm256_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+      __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, xs), _mm256_mul_ps(cy, ys)), ct);
+      _mm256_storeu_ps(result[i].data, r);
+    }
+
+    return i;
+  }
+#endif
+
+  void transform(const Matrix3f& mat, const Vector2f *points, Vector2f *result, std::size_t count) {
+#ifdef GF_TRANSFORM_AVX
+    if (hasAvx()) {
+      std::size_t done = transformAvx(mat, points, result, count);
+      points += done;
+      result += done;
+      count -= done;
+    }
+#endif
+
+    transform(mat, points, sizeof(Vector2f), result, sizeof(Vector2f), count);
+  }
+
+  void transform(const Matrix3f& mat, const Vector2f *points, std::size_t pointsStride, Vector2f *result, std::size_t resultStride, std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef GF_TRANSFORM_SSE2
+    const __m128 cx = _mm_setr_ps(mat.data[0], mat.data[3], mat.data[0], mat.data[3]);
+    const __m128 cy = _mm_setr_ps(mat.data[1], mat.data[4], mat.data[1], mat.data[4]);
+    const __m128 ct = _mm_setr_ps(mat.data[2], mat.data[5], mat.data[2], mat.data[5]);
+
+    for (; i + 2 <= count; i += 2) {
+      __m128 p = loadPoints(pointAt(points, pointsStride, i), pointAt(points, pointsStride, i + 1));
+      __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+      __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+      __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, xs), _mm_mul_ps(cy, ys)), ct);
+      storePoints(r, pointAt(result, resultStride, i), pointAt(result, resultStride, i + 1));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      pointAt(result, resultStride, i) = transform(mat, pointAt(points, pointsStride, i));
+    }
+  }
+
+  RectF computeBounds(const Vector2f *points, std::size_t count, std::size_t stride) {
+    if (count == 0) {
+      return RectF();
+    }
+
+    Vector2f min = points[0];
+    Vector2f max = points[0];
+    std::size_t i = 1;
+
+#ifdef GF_TRANSFORM_SSE2
+    if (count >= 3) {
+      __m128 pmin = loadPoints(pointAt(points, stride, 1), pointAt(points, stride, 2));
+      __m128 pmax = pmin;
+
+      for (i = 3; i + 2 <= count; i += 2) {
+        __m128 p = loadPoints(pointAt(points, stride, i), pointAt(points, stride, i + 1));
+        pmin = _mm_min_ps(pmin, p);
+        pmax = _mm_max_ps(pmax, p);
+      }
+
+      Vector2f mins[2], maxs[2];
+      storePoints(pmin, mins[0], mins[1]);
+      storePoints(pmax, maxs[0], maxs[1]);
+
+      min = gf::min(min, gf::min(mins[0], mins[1]));
+      max = gf::max(max, gf::max(maxs[0], maxs[1]));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      const Vector2f& point = pointAt(points, stride, i);
+      min = gf::min(min, point);
+      max = gf::max(max, point);
+    }
+
+    return RectF(min, max - min);
+  }
+
+  void expandQuads(const Matrix3f *transforms, const Vector2f *sizes, Vector2f *result, std::size_t resultStride, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const Matrix3f& mat = transforms[i];
+      Vector2f size = sizes[i];
+      std::size_t first = i * 4;
+
+#ifdef GF_TRANSFORM_SSE2
+      const __m128 cx = _mm_setr_ps(mat.data[0], mat.data[3], mat.data[0], mat.data[3]);
+      const __m128 cy = _mm_setr_ps(mat.data[1], mat.data[4], mat.data[1], mat.data[4]);
+      const __m128 ct = _mm_setr_ps(mat.data[2], mat.data[5], mat.data[2], mat.data[5]);
+
+      // x is (0, 0, width, width) for both halves, y is 0 for the top and height for the bottom
+      const __m128 xs = _mm_setr_ps(0.0f, 0.0f, size.width, size.width);
+      const __m128 ys = _mm_set1_ps(size.height);
+
+      __m128 top = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, xs), _mm_mul_ps(cy, _mm_setzero_ps())), ct);
+      __m128 bottom = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, xs), _mm_mul_ps(cy, ys)), ct);
+
+      storePoints(top, pointAt(result, resultStride, first), pointAt(result, resultStride, first + 1));
+      storePoints(bottom, pointAt(result, resultStride, first + 2), pointAt(result, resultStride, first + 3));
+#else
+      pointAt(result, resultStride, first + 0) = transform(mat, Vector2f(0.0f, 0.0f));
+      pointAt(result, resultStride, first + 1) = transform(mat, Vector2f(size.width, 0.0f));
+      pointAt(result, resultStride, first + 2) = transform(mat, Vector2f(0.0f, size.height));
+      pointAt(result, resultStride, first + 3) = transform(mat, Vector2f(size.width, size.height));
+#endif
+    }
+  }
+
   void translate(Matrix3f& mat, Vector2f offset) {
     mat *= translation(offset);
   }
@@ -0,0 +1,74 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/Vertex.h>
+
+namespace gf {
+inline namespace v1 {
+
+  static_assert(sizeof(PackedVertex) == 20, "gf::PackedVertex is not packed.");
+
+  static const VertexAttribute VertexAttributes[] = {
+    { "a_position",  "a_position"_id,  2, VertexAttributeType::Float, false, offsetof(Vertex, position) },
+    { "a_color",     "a_color"_id,     4, VertexAttributeType::Float, false, offsetof(Vertex, color) },
+    { "a_texCoords", "a_texCoords"_id, 2, VertexAttributeType::Float, false, offsetof(Vertex, texCoords) },
+  };
+
+  const VertexFormat& Vertex::getFormat() {
+    static const VertexFormat format = { sizeof(Vertex), VertexAttributes, 3 };
+    return format;
+  }
+
+  static const VertexAttribute PackedVertexAttributes[] = {
+    { "a_position",  "a_position"_id,  2, VertexAttributeType::Float,        false, offsetof(PackedVertex, position) },
+    { "a_color",     "a_color"_id,     4, VertexAttributeType::UnsignedByte, true,  offsetof(PackedVertex, color) },
+    { "a_texCoords", "a_texCoords"_id, 2, VertexAttributeType::Float,        false, offsetof(PackedVertex, texCoords) },
+  };
+
+  const VertexFormat& PackedVertex::getFormat() {
+    static const VertexFormat format = { sizeof(PackedVertex), PackedVertexAttributes, 3 };
+    return format;
+  }
+
+  static const VertexAttribute BatchVertexAttributes[] = {
+    { "a_position",    "a_position"_id,    2, VertexAttributeType::Float,        false, offsetof(BatchVertex, position) },
+    { "a_color",       "a_color"_id,       4, VertexAttributeType::UnsignedByte, true,  offsetof(BatchVertex, color) },
+    { "a_texCoords",   "a_texCoords"_id,   2, VertexAttributeType::Float,        false, offsetof(BatchVertex, texCoords) },
+    { "a_textureSlot", "a_textureSlot"_id, 1, VertexAttributeType::Float,        false, offsetof(BatchVertex, textureSlot) },
+  };
+
+  const VertexFormat& BatchVertex::getFormat() {
+    static const VertexFormat format = { sizeof(BatchVertex), BatchVertexAttributes, 4 };
+    return format;
+  }
+
+  static const VertexAttribute InstanceDataAttributes[] = {
+    { "a_instanceRow0",  "a_instanceRow0"_id,  3, VertexAttributeType::Float, false, offsetof(InstanceData, transform) },
+    { "a_instanceRow1",  "a_instanceRow1"_id,  3, VertexAttributeType::Float, false, offsetof(InstanceData, transform) + 3 * sizeof(float) },
+    { "a_instanceColor", "a_instanceColor"_id, 4, VertexAttributeType::Float, false, offsetof(InstanceData, color) },
+  };
+
+  const VertexFormat& InstanceData::getFormat() {
+    static const VertexFormat format = { sizeof(InstanceData), InstanceDataAttributes, 3 };
+    return format;
+  }
+
+}
+}
@@ -24,31 +24,29 @@
 #include <gf/VertexArray.h>
 
 #include <gf/RenderTarget.h>
+#include <gf/Transform.h>
 
 namespace gf {
 inline namespace v1 {
 
-  RectF VertexArray::getBounds() const {
+  template<typename VertexType>
+  RectF BasicVertexArray<VertexType>::getBounds() const {
     if (m_vertices.empty()) {
       return RectF();
     }
 
-    Vector2f min = m_vertices[0].position;
-    Vector2f max = m_vertices[0].position;
-
-    for (const Vertex& vertex : m_vertices) {
-      min = gf::min(min, vertex.position);
-      max = gf::max(max, vertex.position);
-    }
-
-    return RectF(min, max - min);
+    return computeBounds(&m_vertices[0].position, m_vertices.size(), sizeof(VertexType));
   }
 
-  void VertexArray::draw(RenderTarget& target, RenderStates states) {
+  template<typename VertexType>
+  void BasicVertexArray<VertexType>::draw(RenderTarget& target, RenderStates states) {
     if (!m_vertices.empty()) {
       target.draw(m_vertices.data(), m_vertices.size(), m_type, states);
     }
   }
 
+  template class GF_API BasicVertexArray<Vertex>;
+  template class GF_API BasicVertexArray<PackedVertex>;
+
 }
 }
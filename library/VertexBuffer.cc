@@ -20,7 +20,11 @@
  */
 #include <gf/VertexBuffer.h>
 
+#include <cassert>
+#include <cstring>
 #include <algorithm>
+#include <limits>
+#include <utility>
 
 #include <glad/glad.h>
 
@@ -28,25 +32,43 @@
 #include <gf/Vertex.h>
 
 #include "priv/Debug.h"
+#include "priv/Instancing.h"
+#include "priv/Primitives.h"
+#include "priv/RenderCounters.h"
+#include "priv/StateCache.h"
 
 namespace gf {
 inline namespace v1 {
 
   VertexBuffer::VertexBuffer()
+  : VertexBuffer(Usage::Static)
+  {
+
+  }
+
+  VertexBuffer::VertexBuffer(Usage usage)
   : m_vbo(0)
   , m_ebo(0)
   , m_count(0)
   , m_type(PrimitiveType::Points)
+  , m_format(&Vertex::getFormat())
+  , m_usage(usage)
+  , m_vertexCount(0)
+  , m_vboCapacity(0)
+  , m_eboCapacity(0)
+  , m_largeIndices(false)
   {
 
   }
 
   VertexBuffer::~VertexBuffer() {
     if (m_vbo != 0) {
+      priv::getStateCache().forgetBuffer(m_vbo);
       glCheck(glDeleteBuffers(1, &m_vbo));
     }
 
     if (m_ebo != 0) {
+      priv::getStateCache().forgetBuffer(m_ebo);
       glCheck(glDeleteBuffers(1, &m_ebo));
     }
   }
@@ -56,8 +78,20 @@ inline namespace v1 {
   , m_ebo(other.m_ebo)
   , m_count(other.m_count)
   , m_type(other.m_type)
+  , m_format(other.m_format)
+  , m_usage(other.m_usage)
+  , m_vertexCount(other.m_vertexCount)
+  , m_vboCapacity(other.m_vboCapacity)
+  , m_eboCapacity(other.m_eboCapacity)
+  , m_largeIndices(other.m_largeIndices)
+  , m_chunks(std::move(other.m_chunks))
+  , m_splitVertices(std::move(other.m_splitVertices))
+  , m_clientVertices(std::move(other.m_clientVertices))
+  , m_clientIndices(std::move(other.m_clientIndices))
   {
     other.m_vbo = other.m_ebo = 0;
+    other.m_count = other.m_vertexCount = 0;
+    other.m_vboCapacity = other.m_eboCapacity = 0;
   }
 
   VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) {
@@ -65,109 +99,431 @@ inline namespace v1 {
     std::swap(m_ebo, other.m_ebo);
     std::swap(m_count, other.m_count);
     std::swap(m_type, other.m_type);
+    std::swap(m_format, other.m_format);
+    std::swap(m_usage, other.m_usage);
+    std::swap(m_vertexCount, other.m_vertexCount);
+    std::swap(m_vboCapacity, other.m_vboCapacity);
+    std::swap(m_eboCapacity, other.m_eboCapacity);
+    std::swap(m_largeIndices, other.m_largeIndices);
+    std::swap(m_chunks, other.m_chunks);
+    std::swap(m_splitVertices, other.m_splitVertices);
+    std::swap(m_clientVertices, other.m_clientVertices);
+    std::swap(m_clientIndices, other.m_clientIndices);
     return *this;
   }
 
   void VertexBuffer::load(const Vertex *vertices, std::size_t count, PrimitiveType type) {
-    if (vertices == nullptr || count == 0) {
+    loadVertices(vertices, count, Vertex::getFormat(), type);
+  }
+
+  void VertexBuffer::load(const Vertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type) {
+    loadVertices(vertices, Vertex::getFormat(), indices, count, type);
+  }
+
+  void VertexBuffer::load(const PackedVertex *vertices, std::size_t count, PrimitiveType type) {
+    loadVertices(vertices, count, PackedVertex::getFormat(), type);
+  }
+
+  void VertexBuffer::load(const PackedVertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type) {
+    loadVertices(vertices, PackedVertex::getFormat(), indices, count, type);
+  }
+
+  void VertexBuffer::load(const Vertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type) {
+    loadVertices(vertices, Vertex::getFormat(), indices, count, type);
+  }
+
+  void VertexBuffer::load(const PackedVertex *vertices, const uint32_t *indices, std::size_t count, PrimitiveType type) {
+    loadVertices(vertices, PackedVertex::getFormat(), indices, count, type);
+  }
+
+  void VertexBuffer::update(const Vertex *vertices, std::size_t count) {
+    updateVertices(vertices, count, Vertex::getFormat());
+  }
+
+  void VertexBuffer::update(const PackedVertex *vertices, std::size_t count) {
+    updateVertices(vertices, count, PackedVertex::getFormat());
+  }
+
+  void VertexBuffer::updateRange(const Vertex *vertices, std::size_t first, std::size_t count) {
+    updateVertexRange(vertices, first, count, Vertex::getFormat());
+  }
+
+  void VertexBuffer::updateRange(const PackedVertex *vertices, std::size_t first, std::size_t count) {
+    updateVertexRange(vertices, first, count, PackedVertex::getFormat());
+  }
+
+  std::size_t VertexBuffer::getVertexCapacity() const {
+    return m_vboCapacity / m_format->stride;
+  }
+
+  void VertexBuffer::loadVertices(const void *vertices, std::size_t count, const VertexFormat& format, PrimitiveType type) {
+    if (count == 0) {
+      // an empty geometry must not leave the previous one on screen
+      m_count = 0;
       return;
     }
 
-    if (m_vbo != 0 || m_ebo != 0) {
-      Log::warning(Log::Graphics, "Vertex buffer can not be loaded twice.\n");
+    if (vertices == nullptr) {
       return;
     }
 
-    std::size_t vboSize = count * sizeof(Vertex);
+    if (!uploadVertices(vertices, count, format)) {
+      return;
+    }
 
-    glCheck(glGenBuffers(1, &m_vbo));
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
-    glCheck(glBufferData(GL_ARRAY_BUFFER, vboSize, nullptr, GL_STATIC_DRAW));
-    glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, vboSize, vertices));
+    releaseIndices();
 
-    GLint vboUploadedSize = 0;
-    glCheck(glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &vboUploadedSize));
+    m_count = count;
+    m_type = type;
+  }
 
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+  void VertexBuffer::loadVertices(const void *vertices, const VertexFormat& format, const uint16_t *indices, std::size_t count, PrimitiveType type) {
+    assert(type != PrimitiveType::Quads);
 
-    if(vboSize != static_cast<std::size_t>(vboUploadedSize)) {
-      Log::error(Log::Graphics, "Vertex array buffer size in not correct.\n");
-      glCheck(glDeleteBuffers(1, &m_vbo));
-      m_vbo = 0;
+    if (count == 0) {
+      m_count = 0;
+      return;
+    }
+
+    if (vertices == nullptr || indices == nullptr) {
       return;
     }
 
+    std::size_t vertexCount = *std::max_element(indices, indices + count) + std::size_t(1);
+
+    if (!uploadVertices(vertices, vertexCount, format)) {
+      return;
+    }
+
+    if (!uploadIndices(indices, count, sizeof(uint16_t))) {
+      return;
+    }
+
+    m_largeIndices = false;
+    m_chunks.clear();
+    m_splitVertices.clear();
+
+    if (!priv::hasInstancedArrays()) {
+      m_clientIndices.assign(indices, indices + count);
+    }
+
     m_count = count;
     m_type = type;
   }
 
-  void VertexBuffer::load(const Vertex *vertices, const uint16_t *indices, std::size_t count, PrimitiveType type) {
-    if (vertices == nullptr || indices == nullptr || count == 0) {
+  void VertexBuffer::loadVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type) {
+    assert(type != PrimitiveType::Quads);
+
+    if (count == 0) {
+      m_count = 0;
+      return;
+    }
+
+    if (vertices == nullptr || indices == nullptr) {
+      return;
+    }
+
+    uint32_t maxIndex = *std::max_element(indices, indices + count);
+
+    if (maxIndex <= std::numeric_limits<uint16_t>::max()) {
+      // half the size in the graphics memory
+      std::vector<uint16_t> shortIndices(indices, indices + count);
+      loadVertices(vertices, format, shortIndices.data(), count, type);
+      return;
+    }
+
+    if (!GLAD_GL_OES_element_index_uint) {
+      loadSplitVertices(vertices, format, indices, count, type);
+      return;
+    }
+
+    if (!uploadVertices(vertices, std::size_t(maxIndex) + 1, format)) {
+      return;
+    }
+
+    if (!uploadIndices(indices, count, sizeof(uint32_t))) {
+      return;
+    }
+
+    m_largeIndices = true;
+    m_chunks.clear();
+    m_splitVertices.clear();
+
+    if (!priv::hasInstancedArrays()) {
+      m_clientIndices.assign(indices, indices + count);
+    }
+
+    m_count = count;
+    m_type = type;
+  }
+
+  /*
+   * Without 32-bit indices, the primitives are converted to a list, and
+   * split in chunks that have less than 65536 vertices. The vertices of
+   * each chunk are copied in the buffer, one chunk after the other, so a
+   * vertex shared by two chunks appears twice. The original index of each
+   * vertex is kept so that the vertices can be updated.
+   */
+
+  void VertexBuffer::loadSplitVertices(const void *vertices, const VertexFormat& format, const uint32_t *indices, std::size_t count, PrimitiveType type) {
+    std::vector<uint32_t> listIndices;
+    type = priv::appendListIndices(type, indices, count, 0, listIndices);
+
+    std::vector<IndexChunk> chunks;
+    std::vector<uint32_t> splitVertices;
+    std::vector<uint16_t> splitIndices;
+
+    priv::splitIndices(type, listIndices.data(), listIndices.size(), [&](const uint32_t *chunkVertices, std::size_t chunkVertexCount, const uint16_t *chunkIndices, std::size_t chunkIndexCount) {
+      chunks.push_back({ splitVertices.size(), splitIndices.size(), chunkIndexCount });
+      splitVertices.insert(splitVertices.end(), chunkVertices, chunkVertices + chunkVertexCount);
+      splitIndices.insert(splitIndices.end(), chunkIndices, chunkIndices + chunkIndexCount);
+    });
+
+    if (chunks.empty()) {
       return;
     }
 
-    if (m_vbo != 0 || m_ebo != 0) {
-      Log::warning(Log::Graphics, "Vertex buffer can not be loaded twice.\n");
+    const uint8_t *source = static_cast<const uint8_t *>(vertices);
+    std::vector<uint8_t> data(splitVertices.size() * format.stride);
+
+    for (std::size_t i = 0; i < splitVertices.size(); ++i) {
+      std::memcpy(&data[i * format.stride], source + splitVertices[i] * format.stride, format.stride);
+    }
+
+    if (!uploadVertices(data.data(), splitVertices.size(), format)) {
+      return;
+    }
+
+    if (!uploadIndices(splitIndices.data(), splitIndices.size(), sizeof(uint16_t))) {
+      return;
+    }
+
+    if (!priv::hasInstancedArrays()) {
+      m_clientIndices.resize(splitIndices.size());
+
+      for (auto& chunk : chunks) {
+        for (std::size_t i = 0; i < chunk.indexCount; ++i) {
+          m_clientIndices[chunk.indexOffset + i] = static_cast<uint32_t>(chunk.vertexOffset + splitIndices[chunk.indexOffset + i]);
+        }
+      }
+    }
+
+    m_largeIndices = false;
+    m_chunks = std::move(chunks);
+    m_splitVertices = std::move(splitVertices);
+    m_count = splitIndices.size();
+    m_type = type;
+  }
+
+  void VertexBuffer::updateVertices(const void *vertices, std::size_t count, const VertexFormat& format) {
+    if (vertices == nullptr || count == 0) {
       return;
     }
 
-    uint16_t maxIndex = *std::max_element(indices, indices + count);
-    std::size_t vboSize = maxIndex * sizeof(Vertex);
+    if (m_vbo == 0) {
+      Log::warning(Log::Graphics, "Vertex buffer must be loaded before an update.\n");
+      return;
+    }
 
-    glCheck(glGenBuffers(1, &m_vbo));
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
-    glCheck(glBufferData(GL_ARRAY_BUFFER, vboSize, nullptr, GL_STATIC_DRAW));
-    glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, vboSize, vertices));
+    if (!m_splitVertices.empty()) {
+      if (&format != m_format) {
+        Log::warning(Log::Graphics, "Split vertex buffer can not be updated with a different vertex format.\n");
+        return;
+      }
 
-    GLint vboUploadedSize = 0;
-    glCheck(glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &vboUploadedSize));
+      const uint8_t *source = static_cast<const uint8_t *>(vertices);
+      std::vector<uint8_t> data(m_splitVertices.size() * format.stride);
 
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+      for (std::size_t i = 0; i < m_splitVertices.size(); ++i) {
+        if (m_splitVertices[i] >= count) {
+          Log::warning(Log::Graphics, "Split vertex buffer update has too few vertices: %u >= %zu\n", m_splitVertices[i], count);
+          return;
+        }
 
-    if(vboSize != static_cast<std::size_t>(vboUploadedSize)) {
+        std::memcpy(&data[i * format.stride], source + m_splitVertices[i] * format.stride, format.stride);
+      }
+
+      uploadVertices(data.data(), m_splitVertices.size(), format);
+      return;
+    }
+
+    if (!uploadVertices(vertices, count, format)) {
+      return;
+    }
+
+    if (m_ebo == 0) {
+      m_count = count;
+    }
+  }
+
+  void VertexBuffer::updateVertexRange(const void *vertices, std::size_t first, std::size_t count, const VertexFormat& format) {
+    if (vertices == nullptr || count == 0) {
+      return;
+    }
+
+    if (&format != m_format) {
+      Log::warning(Log::Graphics, "Vertex buffer can not be updated with a different vertex format.\n");
+      return;
+    }
+
+    if (!m_splitVertices.empty()) {
+      Log::warning(Log::Graphics, "Split vertex buffer can not be updated partially.\n");
+      return;
+    }
+
+    if (first + count > m_vertexCount) {
+      Log::warning(Log::Graphics, "Vertex buffer range is out of bounds: %zu + %zu > %zu\n", first, count, m_vertexCount);
+      return;
+    }
+
+    std::size_t offset = first * format.stride;
+    std::size_t size = count * format.stride;
+
+    priv::getStateCache().bindArrayBuffer(m_vbo);
+    glCheck(glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices));
+    priv::getRenderCounters().countBufferUpload(size);
+    priv::getStateCache().bindArrayBuffer(0);
+
+    if (!m_clientVertices.empty()) {
+      std::memcpy(m_clientVertices.data() + offset, vertices, size);
+    }
+  }
+
+  static GLenum getEnum(VertexBuffer::Usage usage) {
+    switch (usage) {
+      case VertexBuffer::Usage::Static:
+        return GL_STATIC_DRAW;
+      case VertexBuffer::Usage::Dynamic:
+        return GL_DYNAMIC_DRAW;
+      case VertexBuffer::Usage::Stream:
+        return GL_STREAM_DRAW;
+    }
+
+    assert(false);
+    return GL_STATIC_DRAW;
+  }
+
+  /*
+   * The storage is allocated with the exact size at the first load, and
+   * grows geometrically afterwards so that a buffer that changes often is
+   * not reallocated each time. A stream buffer is orphaned before each
+   * full update, so that the upload does not wait for the previous draw
+   * calls.
+   */
+
+  static bool uploadData(GLenum target, std::size_t& capacity, const void *data, std::size_t size, VertexBuffer::Usage usage) {
+    if (size > capacity) {
+      std::size_t newCapacity = std::max(size, 2 * capacity);
+      glCheck(glBufferData(target, newCapacity, nullptr, getEnum(usage)));
+
+      GLint uploadedSize = 0;
+      glCheck(glGetBufferParameteriv(target, GL_BUFFER_SIZE, &uploadedSize));
+
+      if (newCapacity != static_cast<std::size_t>(uploadedSize)) {
+        capacity = 0;
+        return false;
+      }
+
+      capacity = newCapacity;
+    } else if (usage == VertexBuffer::Usage::Stream) {
+      glCheck(glBufferData(target, capacity, nullptr, getEnum(usage)));
+    }
+
+    glCheck(glBufferSubData(target, 0, size, data));
+    priv::getRenderCounters().countBufferUpload(size);
+    return true;
+  }
+
+  bool VertexBuffer::uploadVertices(const void *vertices, std::size_t count, const VertexFormat& format) {
+    std::size_t vboSize = count * format.stride;
+
+    if (m_vbo == 0) {
+      glCheck(glGenBuffers(1, &m_vbo));
+      m_vboCapacity = 0;
+    }
+
+    priv::getStateCache().bindArrayBuffer(m_vbo);
+    bool uploaded = uploadData(GL_ARRAY_BUFFER, m_vboCapacity, vertices, vboSize, m_usage);
+    priv::getStateCache().bindArrayBuffer(0);
+
+    if (!uploaded) {
       Log::error(Log::Graphics, "Vertex array buffer size in not correct.\n");
+      priv::getStateCache().forgetBuffer(m_vbo);
       glCheck(glDeleteBuffers(1, &m_vbo));
       m_vbo = 0;
-      return;
+      m_vertexCount = 0;
+      m_count = 0;
+      m_clientVertices.clear();
+      releaseIndices();
+      return false;
     }
 
-    std::size_t eboSize = count * sizeof(uint16_t);
+    m_vertexCount = count;
+    m_format = &format;
 
-    glCheck(glGenBuffers(1, &m_ebo));
-    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-    glCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, eboSize, nullptr, GL_STATIC_DRAW));
-    glCheck(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, eboSize, indices));
+    if (!priv::hasInstancedArrays()) {
+      // kept for gf::RenderTarget::drawInstanced()
+      const uint8_t *data = static_cast<const uint8_t *>(vertices);
+      m_clientVertices.assign(data, data + vboSize);
+    }
 
-    GLint eboUploadedSize = 0;
-    glCheck(glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &eboUploadedSize));
+    return true;
+  }
 
-    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+  bool VertexBuffer::uploadIndices(const void *indices, std::size_t count, std::size_t indexSize) {
+    std::size_t eboSize = count * indexSize;
+
+    if (m_ebo == 0) {
+      glCheck(glGenBuffers(1, &m_ebo));
+      m_eboCapacity = 0;
+    }
 
-    if(eboSize != static_cast<std::size_t>(eboUploadedSize)) {
+    priv::getStateCache().bindElementArrayBuffer(m_ebo);
+    bool uploaded = uploadData(GL_ELEMENT_ARRAY_BUFFER, m_eboCapacity, indices, eboSize, m_usage);
+    priv::getStateCache().bindElementArrayBuffer(0);
+
+    if (!uploaded) {
       Log::error(Log::Graphics, "Vertex element array buffer size in not correct.\n");
+      priv::getStateCache().forgetBuffer(m_vbo);
       glCheck(glDeleteBuffers(1, &m_vbo));
       m_vbo = 0;
+      m_vboCapacity = 0;
+      m_vertexCount = 0;
+      m_count = 0;
+      m_clientVertices.clear();
+      releaseIndices();
+      return false;
+    }
+
+    return true;
+  }
+
+  void VertexBuffer::releaseIndices() {
+    if (m_ebo != 0) {
+      priv::getStateCache().forgetBuffer(m_ebo);
       glCheck(glDeleteBuffers(1, &m_ebo));
       m_ebo = 0;
-      return;
     }
 
-    m_count = count;
-    m_type = type;
+    m_eboCapacity = 0;
+    m_largeIndices = false;
+    m_chunks.clear();
+    m_splitVertices.clear();
+    m_clientIndices.clear();
   }
 
   void VertexBuffer::bind(const VertexBuffer *buffer) {
     if (buffer != nullptr) {
       if (buffer->m_vbo != 0) {
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer->m_vbo));
+        priv::getStateCache().bindArrayBuffer(buffer->m_vbo);
       }
 
       if (buffer->m_ebo != 0) {
-        glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->m_ebo));
+        priv::getStateCache().bindElementArrayBuffer(buffer->m_ebo);
       }
     } else {
-      glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-      glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+      priv::getStateCache().bindArrayBuffer(0);
+      priv::getStateCache().bindElementArrayBuffer(0);
     }
   }
 
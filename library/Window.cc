@@ -36,6 +36,8 @@
 #include <gf/Mouse.h>
 #include <gf/Vector.h>
 
+#include "priv/Debug.h"
+
 namespace gf {
 inline namespace v1 {
 
@@ -64,12 +66,24 @@ inline namespace v1 {
       return nullptr;
     }
 
+    // some drivers only send messages to the debug callback in a debug context
+    int flags = priv::getDebugSettings().mode == GraphicsDebug::Mode::Callback ? SDL_GL_CONTEXT_DEBUG_FLAG : 0;
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, flags);
+
     void *context = SDL_GL_CreateContext(window);
+
+    if (context == nullptr && flags != 0) {
+      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+      context = SDL_GL_CreateContext(window);
+    }
+
     int err = SDL_GL_MakeCurrent(window, context);
     assert(err == 0);
 
     if (!gladLoadGLES2Loader(SDL_GL_GetProcAddress)) {
       Log::error(Log::Graphics, "Failed to load GLES2.\n");
+    } else {
+      priv::initializeDebug();
     }
 
     return context;
@@ -0,0 +1,741 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include "CompressedImage.h"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+#include <gf/Log.h>
+
+#include "Debug.h"
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Containers
+     *
+     * Only 2D textures are supported: no arrays, no cube maps, no volumes.
+     * The levels are stored from the largest to the smallest.
+     */
+
+    static constexpr uint8_t KtxIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static constexpr uint8_t DdsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+    static uint32_t readLittleEndian32(const uint8_t *data) {
+      return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+    }
+
+    static uint64_t readBigEndian64(const uint8_t *data) {
+      uint64_t value = 0;
+
+      for (std::size_t i = 0; i < 8; ++i) {
+        value = (value << 8) | data[i];
+      }
+
+      return value;
+    }
+
+    static uint32_t swapBytes(uint32_t value) {
+      return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+    }
+
+    static Vector2u getLevelSize(Vector2u size, std::size_t level) {
+      return { std::max(size.width >> level, 1u), std::max(size.height >> level, 1u) };
+    }
+
+    // floor(log2(max(width, height))) + 1, the levels down to 1x1
+    static uint32_t getMaxLevelCount(Vector2u size) {
+      uint32_t extent = std::max(size.width, size.height);
+      uint32_t count = 0;
+
+      while (extent != 0) {
+        extent >>= 1;
+        ++count;
+      }
+
+      return count;
+    }
+
+    bool isCompressedContainer(const uint8_t *data, std::size_t length) {
+      if (length >= sizeof KtxIdentifier && std::memcmp(data, KtxIdentifier, sizeof KtxIdentifier) == 0) {
+        return true;
+      }
+
+      return length >= sizeof DdsMagic && std::memcmp(data, DdsMagic, sizeof DdsMagic) == 0;
+    }
+
+    static bool loadKtx(const uint8_t *data, std::size_t length, CompressedImage& image) {
+      static constexpr std::size_t HeaderSize = 64;
+
+      if (length < HeaderSize) {
+        Log::error(Log::Graphics, "Truncated KTX header.\n");
+        return false;
+      }
+
+      // 13 values after the identifier, the first one gives the endianness of the file
+      uint32_t endianness = readLittleEndian32(data + sizeof KtxIdentifier);
+
+      if (endianness != 0x04030201 && endianness != 0x01020304) {
+        Log::error(Log::Graphics, "Invalid KTX endianness.\n");
+        return false;
+      }
+
+      bool swap = (endianness != 0x04030201);
+
+      auto field = [data, swap](std::size_t offset) {
+        uint32_t value = readLittleEndian32(data + offset);
+        return swap ? swapBytes(value) : value;
+      };
+
+      uint32_t glType = field(16);
+      uint32_t glInternalFormat = field(28);
+      Vector2u size(field(36), field(40));
+      uint32_t depth = field(44);
+      uint32_t arrayElements = field(48);
+      uint32_t faces = field(52);
+      uint32_t levelCount = std::max(field(56), UINT32_C(1));
+      uint32_t keyValueSize = field(60);
+
+      if (glType != 0) {
+        Log::error(Log::Graphics, "Only compressed KTX textures are supported.\n");
+        return false;
+      }
+
+      if (size.width == 0 || size.height == 0 || depth > 1 || arrayElements > 0 || faces != 1) {
+        Log::error(Log::Graphics, "Only 2D KTX textures are supported.\n");
+        return false;
+      }
+
+      if (levelCount > getMaxLevelCount(size)) {
+        Log::error(Log::Graphics, "Invalid number of KTX levels: %u\n", levelCount);
+        return false;
+      }
+
+      std::size_t offset = HeaderSize + keyValueSize;
+      image.format = glInternalFormat;
+      image.levels.clear();
+
+      for (uint32_t i = 0; i < levelCount; ++i) {
+        if (offset + 4 > length) {
+          Log::error(Log::Graphics, "Truncated KTX data.\n");
+          return false;
+        }
+
+        std::size_t levelLength = field(offset);
+        offset += 4;
+
+        if (offset + levelLength > length) {
+          Log::error(Log::Graphics, "Truncated KTX data.\n");
+          return false;
+        }
+
+        image.levels.push_back({ getLevelSize(size, i), data + offset, levelLength });
+        offset += (levelLength + 3) / 4 * 4;
+      }
+
+      return true;
+    }
+
+    static constexpr uint32_t makeFourCC(char c0, char c1, char c2, char c3) {
+      return uint32_t(c0) | (uint32_t(c1) << 8) | (uint32_t(c2) << 16) | (uint32_t(c3) << 24);
+    }
+
+    static bool loadDds(const uint8_t *data, std::size_t length, CompressedImage& image) {
+      static constexpr std::size_t HeaderSize = 4 + 124;
+      static constexpr std::size_t ExtendedHeaderSize = 20;
+      static constexpr uint32_t PixelFormatFourCC = 0x4;
+      static constexpr uint32_t Caps2CubeMap = 0x200;
+      static constexpr uint32_t DxgiFormatBC1 = 71;
+      static constexpr uint32_t DxgiFormatBC1Srgb = 72;
+      static constexpr uint32_t DxgiFormatBC2 = 74;
+      static constexpr uint32_t DxgiFormatBC2Srgb = 75;
+      static constexpr uint32_t DxgiFormatBC3 = 77;
+      static constexpr uint32_t DxgiFormatBC3Srgb = 78;
+      static constexpr uint32_t DimensionTexture2D = 3;
+
+      if (length < HeaderSize) {
+        Log::error(Log::Graphics, "Truncated DDS header.\n");
+        return false;
+      }
+
+      const uint8_t *header = data + 4;
+      Vector2u size(readLittleEndian32(header + 12), readLittleEndian32(header + 8));
+      uint32_t levelCount = std::max(readLittleEndian32(header + 24), UINT32_C(1));
+      uint32_t pixelFormatFlags = readLittleEndian32(header + 76);
+      uint32_t fourCC = readLittleEndian32(header + 80);
+      uint32_t caps2 = readLittleEndian32(header + 108);
+
+      if (size.width == 0 || size.height == 0 || (caps2 & Caps2CubeMap) != 0) {
+        Log::error(Log::Graphics, "Only 2D DDS textures are supported.\n");
+        return false;
+      }
+
+      if ((pixelFormatFlags & PixelFormatFourCC) == 0) {
+        Log::error(Log::Graphics, "Only compressed DDS textures are supported.\n");
+        return false;
+      }
+
+      if (levelCount > getMaxLevelCount(size)) {
+        Log::error(Log::Graphics, "Invalid number of DDS levels: %u\n", levelCount);
+        return false;
+      }
+
+      std::size_t offset = HeaderSize;
+      image.format = 0;
+
+      if (fourCC == makeFourCC('D', 'X', 'T', '1')) {
+        image.format = CompressedRgbaS3tcDxt1;
+      } else if (fourCC == makeFourCC('D', 'X', 'T', '3')) {
+        image.format = CompressedRgbaS3tcDxt3;
+      } else if (fourCC == makeFourCC('D', 'X', 'T', '5')) {
+        image.format = CompressedRgbaS3tcDxt5;
+      } else if (fourCC == makeFourCC('D', 'X', '1', '0')) {
+        if (length < HeaderSize + ExtendedHeaderSize) {
+          Log::error(Log::Graphics, "Truncated DDS header.\n");
+          return false;
+        }
+
+        const uint8_t *extended = data + HeaderSize;
+        uint32_t dxgiFormat = readLittleEndian32(extended);
+        uint32_t dimension = readLittleEndian32(extended + 4);
+        uint32_t arraySize = readLittleEndian32(extended + 12);
+
+        if (dimension != DimensionTexture2D || arraySize > 1) {
+          Log::error(Log::Graphics, "Only 2D DDS textures are supported.\n");
+          return false;
+        }
+
+        switch (dxgiFormat) {
+          case DxgiFormatBC1:
+          case DxgiFormatBC1Srgb:
+            image.format = CompressedRgbaS3tcDxt1;
+            break;
+          case DxgiFormatBC2:
+          case DxgiFormatBC2Srgb:
+            image.format = CompressedRgbaS3tcDxt3;
+            break;
+          case DxgiFormatBC3:
+          case DxgiFormatBC3Srgb:
+            image.format = CompressedRgbaS3tcDxt5;
+            break;
+          default:
+            break;
+        }
+
+        offset += ExtendedHeaderSize;
+      }
+
+      if (image.format == 0) {
+        Log::error(Log::Graphics, "Unsupported DDS format.\n");
+        return false;
+      }
+
+      std::size_t blockSize = (image.format == CompressedRgbaS3tcDxt1) ? 8 : 16;
+      image.levels.clear();
+
+      for (uint32_t i = 0; i < levelCount; ++i) {
+        Vector2u levelSize = getLevelSize(size, i);
+        std::size_t levelLength = ((levelSize.width + 3) / 4) * ((levelSize.height + 3) / 4) * blockSize;
+
+        if (offset + levelLength > length) {
+          Log::error(Log::Graphics, "Truncated DDS data.\n");
+          return false;
+        }
+
+        image.levels.push_back({ levelSize, data + offset, levelLength });
+        offset += levelLength;
+      }
+
+      return true;
+    }
+
+    bool loadCompressedImage(const uint8_t *data, std::size_t length, CompressedImage& image) {
+      if (length >= sizeof KtxIdentifier && std::memcmp(data, KtxIdentifier, sizeof KtxIdentifier) == 0) {
+        return loadKtx(data, length, image);
+      }
+
+      if (length >= sizeof DdsMagic && std::memcmp(data, DdsMagic, sizeof DdsMagic) == 0) {
+        return loadDds(data, length, image);
+      }
+
+      Log::error(Log::Graphics, "Unknown compressed texture container.\n");
+      return false;
+    }
+
+    const char *getCompressedFormatName(GLenum format) {
+      switch (format) {
+        case CompressedRgbEtc1:
+          return "ETC1";
+        case CompressedRgbEtc2:
+          return "ETC2 RGB";
+        case CompressedRgbaEtc2:
+          return "ETC2 RGBA";
+        case CompressedRgbS3tcDxt1:
+        case CompressedRgbaS3tcDxt1:
+          return "S3TC DXT1";
+        case CompressedRgbaS3tcDxt3:
+          return "S3TC DXT3";
+        case CompressedRgbaS3tcDxt5:
+          return "S3TC DXT5";
+        default:
+          break;
+      }
+
+      if (format >= CompressedRgbaAstcFirst && format <= CompressedRgbaAstcLast) {
+        return "ASTC";
+      }
+
+      return "Unknown";
+    }
+
+    bool isCompressedFormatSupported(GLenum format) {
+      GLint count = 0;
+      glCheck(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+
+      if (count <= 0) {
+        return false;
+      }
+
+      std::vector<GLint> formats(count);
+      glCheck(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data()));
+      return std::find(formats.begin(), formats.end(), static_cast<GLint>(format)) != formats.end();
+    }
+
+    /*
+     * Decoders
+     *
+     * A block is decoded in a 4x4 array of RGBA pixels, in row-major order.
+     */
+
+    static constexpr std::size_t BlockSize = 4;
+
+    using Block = uint8_t[BlockSize * BlockSize][4];
+
+    static uint8_t clampComponent(int value) {
+      return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+    }
+
+    // S3TC
+
+    static void decodeDxtColor(const uint8_t *data, bool punchThrough, bool opaque, Block& block) {
+      uint16_t c0 = data[0] | (data[1] << 8);
+      uint16_t c1 = data[2] | (data[3] << 8);
+
+      int colors[4][4];
+
+      for (int i = 0; i < 2; ++i) {
+        uint16_t c = (i == 0) ? c0 : c1;
+        int r = (c >> 11) & 0x1F;
+        int g = (c >> 5) & 0x3F;
+        int b = c & 0x1F;
+        colors[i][0] = (r << 3) | (r >> 2);
+        colors[i][1] = (g << 2) | (g >> 4);
+        colors[i][2] = (b << 3) | (b >> 2);
+        colors[i][3] = 255;
+      }
+
+      if (c0 > c1 || !punchThrough) {
+        for (int j = 0; j < 3; ++j) {
+          colors[2][j] = (2 * colors[0][j] + colors[1][j]) / 3;
+          colors[3][j] = (colors[0][j] + 2 * colors[1][j]) / 3;
+        }
+
+        colors[2][3] = colors[3][3] = 255;
+      } else {
+        for (int j = 0; j < 3; ++j) {
+          colors[2][j] = (colors[0][j] + colors[1][j]) / 2;
+          colors[3][j] = 0;
+        }
+
+        colors[2][3] = 255;
+        colors[3][3] = opaque ? 255 : 0;
+      }
+
+      uint32_t indices = readLittleEndian32(data + 4);
+
+      for (std::size_t i = 0; i < BlockSize * BlockSize; ++i) {
+        unsigned index = (indices >> (2 * i)) & 0x3;
+
+        for (int j = 0; j < 4; ++j) {
+          block[i][j] = static_cast<uint8_t>(colors[index][j]);
+        }
+      }
+    }
+
+    static void decodeDxt3Alpha(const uint8_t *data, Block& block) {
+      for (std::size_t i = 0; i < BlockSize * BlockSize; ++i) {
+        unsigned alpha = (data[i / 2] >> (4 * (i % 2))) & 0xF;
+        block[i][3] = static_cast<uint8_t>(alpha * 17);
+      }
+    }
+
+    static void decodeDxt5Alpha(const uint8_t *data, Block& block) {
+      int a0 = data[0];
+      int a1 = data[1];
+      int alphas[8] = { a0, a1, 0, 0, 0, 0, 0, 0 };
+
+      if (a0 > a1) {
+        for (int i = 1; i < 7; ++i) {
+          alphas[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+      } else {
+        for (int i = 1; i < 5; ++i) {
+          alphas[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        }
+
+        alphas[6] = 0;
+        alphas[7] = 255;
+      }
+
+      uint64_t indices = 0;
+
+      for (std::size_t i = 0; i < 6; ++i) {
+        indices |= uint64_t(data[2 + i]) << (8 * i);
+      }
+
+      for (std::size_t i = 0; i < BlockSize * BlockSize; ++i) {
+        block[i][3] = static_cast<uint8_t>(alphas[(indices >> (3 * i)) & 0x7]);
+      }
+    }
+
+    // ETC1 and ETC2, the pixels of a block are indexed in column-major order
+
+    static constexpr int EtcModifiers[8][4] = {
+      {  2,   8,  -2,   -8 },
+      {  5,  17,  -5,  -17 },
+      {  9,  29,  -9,  -29 },
+      { 13,  42, -13,  -42 },
+      { 18,  60, -18,  -60 },
+      { 24,  80, -24,  -80 },
+      { 33, 106, -33, -106 },
+      { 47, 183, -47, -183 },
+    };
+
+    static constexpr int EtcDistances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+    static constexpr int EacModifiers[16][8] = {
+      { -3, -6,  -9, -15, 2, 5, 8, 14 },
+      { -3, -7, -10, -13, 2, 6, 9, 12 },
+      { -2, -5,  -8, -13, 1, 4, 7, 12 },
+      { -2, -4,  -6, -13, 1, 3, 5, 12 },
+      { -3, -6,  -8, -12, 2, 5, 7, 11 },
+      { -3, -7,  -9, -11, 2, 6, 8, 10 },
+      { -4, -7,  -8, -11, 3, 6, 7, 10 },
+      { -3, -5,  -8, -11, 2, 4, 7, 10 },
+      { -2, -6,  -8, -10, 1, 5, 7,  9 },
+      { -2, -5,  -8, -10, 1, 4, 7,  9 },
+      { -2, -4,  -8, -10, 1, 3, 7,  9 },
+      { -2, -5,  -7, -10, 1, 4, 6,  9 },
+      { -3, -4,  -7, -10, 2, 3, 6,  9 },
+      { -1, -2,  -3, -10, 0, 1, 2,  9 },
+      { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+      { -3, -5,  -7,  -9, 2, 4, 6,  8 },
+    };
+
+    static int extend4(int value) {
+      return (value << 4) | value;
+    }
+
+    static int extend5(int value) {
+      return (value << 3) | (value >> 2);
+    }
+
+    static int extend6(int value) {
+      return (value << 2) | (value >> 4);
+    }
+
+    static int extend7(int value) {
+      return (value << 1) | (value >> 6);
+    }
+
+    static unsigned getEtcIndex(uint32_t low, std::size_t x, std::size_t y) {
+      std::size_t p = x * BlockSize + y;
+      return (((low >> (p + 16)) & 0x1) << 1) | ((low >> p) & 0x1);
+    }
+
+    static void setPixel(Block& block, std::size_t x, std::size_t y, int r, int g, int b) {
+      uint8_t *pixel = block[y * BlockSize + x];
+      pixel[0] = clampComponent(r);
+      pixel[1] = clampComponent(g);
+      pixel[2] = clampComponent(b);
+      pixel[3] = 255;
+    }
+
+    static void decodeEtcPaints(uint32_t low, const int paints[4][3], Block& block) {
+      for (std::size_t x = 0; x < BlockSize; ++x) {
+        for (std::size_t y = 0; y < BlockSize; ++y) {
+          const int *paint = paints[getEtcIndex(low, x, y)];
+          setPixel(block, x, y, paint[0], paint[1], paint[2]);
+        }
+      }
+    }
+
+    static void decodeEtcT(uint32_t high, uint32_t low, Block& block) {
+      int c1[3] = {
+        extend4((((high >> 27) & 0x3) << 2) | ((high >> 24) & 0x3)),
+        extend4((high >> 20) & 0xF),
+        extend4((high >> 16) & 0xF)
+      };
+
+      int c2[3] = { extend4((high >> 12) & 0xF), extend4((high >> 8) & 0xF), extend4((high >> 4) & 0xF) };
+      int d = EtcDistances[(((high >> 2) & 0x3) << 1) | (high & 0x1)];
+
+      int paints[4][3];
+
+      for (int j = 0; j < 3; ++j) {
+        paints[0][j] = c1[j];
+        paints[1][j] = c2[j] + d;
+        paints[2][j] = c2[j];
+        paints[3][j] = c2[j] - d;
+      }
+
+      decodeEtcPaints(low, paints, block);
+    }
+
+    static void decodeEtcH(uint32_t high, uint32_t low, Block& block) {
+      int r1 = (high >> 27) & 0xF;
+      int g1 = (((high >> 24) & 0x7) << 1) | ((high >> 20) & 0x1);
+      int b1 = (((high >> 19) & 0x1) << 3) | ((high >> 15) & 0x7);
+      int r2 = (high >> 11) & 0xF;
+      int g2 = (high >> 7) & 0xF;
+      int b2 = (high >> 3) & 0xF;
+
+      int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+      int d = EtcDistances[(((high >> 2) & 0x1) << 2) | ((high & 0x1) << 1) | order];
+
+      int c1[3] = { extend4(r1), extend4(g1), extend4(b1) };
+      int c2[3] = { extend4(r2), extend4(g2), extend4(b2) };
+
+      int paints[4][3];
+
+      for (int j = 0; j < 3; ++j) {
+        paints[0][j] = c1[j] + d;
+        paints[1][j] = c1[j] - d;
+        paints[2][j] = c2[j] + d;
+        paints[3][j] = c2[j] - d;
+      }
+
+      decodeEtcPaints(low, paints, block);
+    }
+
+    static void decodeEtcPlanar(uint64_t bits, Block& block) {
+      int o[3] = {
+        extend6((bits >> 57) & 0x3F),
+        extend7((((bits >> 56) & 0x1) << 6) | ((bits >> 49) & 0x3F)),
+        extend6((((bits >> 48) & 0x1) << 5) | (((bits >> 43) & 0x3) << 3) | ((bits >> 39) & 0x7))
+      };
+
+      int h[3] = {
+        extend6((((bits >> 34) & 0x1F) << 1) | ((bits >> 32) & 0x1)),
+        extend7((bits >> 25) & 0x7F),
+        extend6((bits >> 19) & 0x3F)
+      };
+
+      int v[3] = {
+        extend6((bits >> 13) & 0x3F),
+        extend7((bits >> 6) & 0x7F),
+        extend6(bits & 0x3F)
+      };
+
+      for (std::size_t x = 0; x < BlockSize; ++x) {
+        for (std::size_t y = 0; y < BlockSize; ++y) {
+          int c[3];
+          int ix = static_cast<int>(x);
+          int iy = static_cast<int>(y);
+
+          for (int j = 0; j < 3; ++j) {
+            c[j] = (ix * (h[j] - o[j]) + iy * (v[j] - o[j]) + 4 * o[j] + 2) / 4;
+          }
+
+          setPixel(block, x, y, c[0], c[1], c[2]);
+        }
+      }
+    }
+
+    static int signExtend3(int value) {
+      return (value & 0x4) != 0 ? value - 8 : value;
+    }
+
+    // ETC1 blocks are valid ETC2 blocks
+    static void decodeEtcColor(const uint8_t *data, Block& block) {
+      uint64_t bits = readBigEndian64(data);
+      uint32_t high = static_cast<uint32_t>(bits >> 32);
+      uint32_t low = static_cast<uint32_t>(bits);
+
+      int bases[2][3];
+
+      if ((high & 0x2) == 0) {
+        // individual mode
+        bases[0][0] = extend4((high >> 28) & 0xF);
+        bases[1][0] = extend4((high >> 24) & 0xF);
+        bases[0][1] = extend4((high >> 20) & 0xF);
+        bases[1][1] = extend4((high >> 16) & 0xF);
+        bases[0][2] = extend4((high >> 12) & 0xF);
+        bases[1][2] = extend4((high >> 8) & 0xF);
+      } else {
+        // differential mode, an overflow selects an ETC2 mode
+        int r = (high >> 27) & 0x1F;
+        int g = (high >> 19) & 0x1F;
+        int b = (high >> 11) & 0x1F;
+        int dr = r + signExtend3((high >> 24) & 0x7);
+        int dg = g + signExtend3((high >> 16) & 0x7);
+        int db = b + signExtend3((high >> 8) & 0x7);
+
+        if (dr < 0 || dr > 31) {
+          decodeEtcT(high, low, block);
+          return;
+        }
+
+        if (dg < 0 || dg > 31) {
+          decodeEtcH(high, low, block);
+          return;
+        }
+
+        if (db < 0 || db > 31) {
+          decodeEtcPlanar(bits, block);
+          return;
+        }
+
+        bases[0][0] = extend5(r);
+        bases[0][1] = extend5(g);
+        bases[0][2] = extend5(b);
+        bases[1][0] = extend5(dr);
+        bases[1][1] = extend5(dg);
+        bases[1][2] = extend5(db);
+      }
+
+      const int *tables[2] = { EtcModifiers[(high >> 5) & 0x7], EtcModifiers[(high >> 2) & 0x7] };
+      bool flip = (high & 0x1) != 0;
+
+      for (std::size_t x = 0; x < BlockSize; ++x) {
+        for (std::size_t y = 0; y < BlockSize; ++y) {
+          std::size_t sub = flip ? (y / 2) : (x / 2);
+          int modifier = tables[sub][getEtcIndex(low, x, y)];
+          setPixel(block, x, y, bases[sub][0] + modifier, bases[sub][1] + modifier, bases[sub][2] + modifier);
+        }
+      }
+    }
+
+    static void decodeEacAlpha(const uint8_t *data, Block& block) {
+      uint64_t bits = readBigEndian64(data);
+      int base = static_cast<int>(bits >> 56);
+      int multiplier = static_cast<int>((bits >> 52) & 0xF);
+      const int *modifiers = EacModifiers[(bits >> 48) & 0xF];
+
+      for (std::size_t x = 0; x < BlockSize; ++x) {
+        for (std::size_t y = 0; y < BlockSize; ++y) {
+          std::size_t p = x * BlockSize + y;
+          unsigned index = (bits >> (45 - 3 * p)) & 0x7;
+          block[y * BlockSize + x][3] = clampComponent(base + modifiers[index] * multiplier);
+        }
+      }
+    }
+
+    static std::size_t getBlockLength(GLenum format) {
+      switch (format) {
+        case CompressedRgbEtc1:
+        case CompressedRgbEtc2:
+        case CompressedRgbS3tcDxt1:
+        case CompressedRgbaS3tcDxt1:
+          return 8;
+        case CompressedRgbaEtc2:
+        case CompressedRgbaS3tcDxt3:
+        case CompressedRgbaS3tcDxt5:
+          return 16;
+        default:
+          break;
+      }
+
+      return 0;
+    }
+
+    static void decodeBlock(GLenum format, const uint8_t *data, Block& block) {
+      switch (format) {
+        case CompressedRgbEtc1:
+        case CompressedRgbEtc2:
+          decodeEtcColor(data, block);
+          break;
+        case CompressedRgbaEtc2:
+          decodeEtcColor(data + 8, block);
+          decodeEacAlpha(data, block);
+          break;
+        case CompressedRgbS3tcDxt1:
+          decodeDxtColor(data, true, true, block);
+          break;
+        case CompressedRgbaS3tcDxt1:
+          decodeDxtColor(data, true, false, block);
+          break;
+        case CompressedRgbaS3tcDxt3:
+          decodeDxtColor(data + 8, false, true, block);
+          decodeDxt3Alpha(data, block);
+          break;
+        case CompressedRgbaS3tcDxt5:
+          decodeDxtColor(data + 8, false, true, block);
+          decodeDxt5Alpha(data, block);
+          break;
+        default:
+          assert(false);
+          break;
+      }
+    }
+
+    bool decodeCompressedLevel(GLenum format, const CompressedLevel& level, std::vector<uint8_t>& pixels) {
+      std::size_t blockLength = getBlockLength(format);
+
+      if (blockLength == 0) {
+        return false;
+      }
+
+      std::size_t blocksX = (level.size.width + BlockSize - 1) / BlockSize;
+      std::size_t blocksY = (level.size.height + BlockSize - 1) / BlockSize;
+
+      if (blocksX * blocksY * blockLength > level.length) {
+        Log::error(Log::Graphics, "Truncated compressed texture data.\n");
+        return false;
+      }
+
+      pixels.resize(level.size.width * level.size.height * 4);
+      const uint8_t *data = level.data;
+
+      for (std::size_t by = 0; by < blocksY; ++by) {
+        for (std::size_t bx = 0; bx < blocksX; ++bx) {
+          Block block;
+          decodeBlock(format, data, block);
+          data += blockLength;
+
+          // the blocks on the right and bottom borders may be partial
+          std::size_t width = std::min(BlockSize, level.size.width - bx * BlockSize);
+          std::size_t height = std::min(BlockSize, level.size.height - by * BlockSize);
+
+          for (std::size_t y = 0; y < height; ++y) {
+            uint8_t *row = &pixels[((by * BlockSize + y) * level.size.width + bx * BlockSize) * 4];
+            std::memcpy(row, block[y * BlockSize], width * 4);
+          }
+        }
+      }
+
+      return true;
+    }
+
+  }
+}
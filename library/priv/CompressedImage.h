@@ -0,0 +1,82 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_COMPRESSED_IMAGE_H
+#define GF_COMPRESSED_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <gf/Portability.h>
+#include <gf/Vector.h>
+
+namespace gf {
+  namespace priv {
+
+    // the compressed formats, the ETC2 and ASTC enums are not all defined by the GLES2 headers
+    constexpr GLenum CompressedRgbEtc1 = 0x8D64;
+    constexpr GLenum CompressedRgbEtc2 = 0x9274;
+    constexpr GLenum CompressedRgbaEtc2 = 0x9278;
+    constexpr GLenum CompressedRgbS3tcDxt1 = 0x83F0;
+    constexpr GLenum CompressedRgbaS3tcDxt1 = 0x83F1;
+    constexpr GLenum CompressedRgbaS3tcDxt3 = 0x83F2;
+    constexpr GLenum CompressedRgbaS3tcDxt5 = 0x83F3;
+    constexpr GLenum CompressedRgbaAstcFirst = 0x93B0; // 4x4
+    constexpr GLenum CompressedRgbaAstcLast = 0x93BD; // 12x12
+
+    struct CompressedLevel {
+      Vector2u size;
+      const uint8_t *data;
+      std::size_t length;
+    };
+
+    /*
+     * A compressed image from a KTX or DDS container
+     *
+     * The levels point into the data of the container, that must outlive
+     * the image.
+     */
+    struct CompressedImage {
+      GLenum format = 0;
+      std::vector<CompressedLevel> levels;
+    };
+
+    // the container and decoding functions are exported for the tests
+
+    // tell if the data starts with the magic of a KTX or DDS container
+    GF_API bool isCompressedContainer(const uint8_t *data, std::size_t length);
+
+    GF_API bool loadCompressedImage(const uint8_t *data, std::size_t length, CompressedImage& image);
+
+    const char *getCompressedFormatName(GLenum format);
+
+    // the format is in the list of the compressed formats of the context
+    bool isCompressedFormatSupported(GLenum format);
+
+    // decode a level to RGBA pixels, for ETC1, ETC2 (RGB and RGBA) and S3TC
+    GF_API bool decodeCompressedLevel(GLenum format, const CompressedLevel& level, std::vector<uint8_t>& pixels);
+
+  }
+}
+
+#endif // GF_COMPRESSED_IMAGE_H
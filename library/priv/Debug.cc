@@ -24,10 +24,30 @@
 
 #include <gf/Log.h>
 
+#include "Utils.h"
+
 namespace gf {
   namespace priv {
 
+    struct CallLocation {
+      const char *file = nullptr;
+      unsigned int line = 0;
+      const char *expr = nullptr;
+    };
+
+    static CallLocation lastCall;
+
+    void glCheckCall(const char *file, unsigned int line, const char *expr) {
+      lastCall.file = file;
+      lastCall.line = line;
+      lastCall.expr = expr;
+    }
+
     void glCheckError(const char *file, unsigned int line, const char *expr) {
+      if (getDebugSettings().mode != GraphicsDebug::Mode::Check) {
+        return;
+      }
+
       GLenum code = glGetError();
 
       if (code == GL_NO_ERROR) {
@@ -67,5 +87,148 @@ namespace gf {
       );
     }
 
+    DebugSettings& getDebugSettings() {
+      static DebugSettings settings;
+      return settings;
+    }
+
+    static const char *getSourceName(GLenum source) {
+      switch (source) {
+        case GL_DEBUG_SOURCE_API_KHR:
+          return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM_KHR:
+          return "Window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER_KHR:
+          return "Shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY_KHR:
+          return "Third party";
+        case GL_DEBUG_SOURCE_APPLICATION_KHR:
+          return "Application";
+        default:
+          break;
+      }
+
+      return "Other";
+    }
+
+    static const char *getTypeName(GLenum type) {
+      switch (type) {
+        case GL_DEBUG_TYPE_ERROR_KHR:
+          return "Error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR_KHR:
+          return "Deprecated behavior";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR_KHR:
+          return "Undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY_KHR:
+          return "Portability";
+        case GL_DEBUG_TYPE_PERFORMANCE_KHR:
+          return "Performance";
+        default:
+          break;
+      }
+
+      return "Other";
+    }
+
+    static Log::Level getLevel(GLenum severity) {
+      switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH_KHR:
+          return Log::Error;
+        case GL_DEBUG_SEVERITY_MEDIUM_KHR:
+          return Log::Warn;
+        case GL_DEBUG_SEVERITY_LOW_KHR:
+          return Log::Info;
+        default:
+          break;
+      }
+
+      return Log::Debug;
+    }
+
+    static void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam) {
+      GF_UNUSED(id);
+      GF_UNUSED(length);
+      GF_UNUSED(userParam);
+
+      const char *format = "OpenGL message:\n\tSource: %s\n\tType: %s\n\tMessage: %s\n";
+      const char *locationFormat = "OpenGL message:\n\tSource: %s\n\tType: %s\n\tMessage: %s\n\tLocation: %s%s:%u\n\tExpression: %s\n";
+      const char *sourceName = getSourceName(source);
+      const char *typeName = getTypeName(type);
+      // in asynchronous mode, the message comes from this call or from a previous one
+      const char *accuracy = getDebugSettings().synchronous ? "" : "near ";
+
+      switch (getLevel(severity)) {
+        case Log::Error:
+          if (lastCall.file != nullptr) {
+            Log::error(Log::Graphics, locationFormat, sourceName, typeName, message, accuracy, lastCall.file, lastCall.line, lastCall.expr);
+          } else {
+            Log::error(Log::Graphics, format, sourceName, typeName, message);
+          }
+          break;
+        case Log::Warn:
+          if (lastCall.file != nullptr) {
+            Log::warning(Log::Graphics, locationFormat, sourceName, typeName, message, accuracy, lastCall.file, lastCall.line, lastCall.expr);
+          } else {
+            Log::warning(Log::Graphics, format, sourceName, typeName, message);
+          }
+          break;
+        case Log::Info:
+          Log::info(Log::Graphics, format, sourceName, typeName, message);
+          break;
+        default:
+          Log::debug(Log::Graphics, format, sourceName, typeName, message);
+          break;
+      }
+    }
+
+    void initializeDebug() {
+      getDebugSettings().contextReady = true;
+      applyDebugSettings();
+    }
+
+    void applyDebugSettings() {
+      DebugSettings& settings = getDebugSettings();
+
+#ifndef GF_DEBUG
+      if (settings.mode == GraphicsDebug::Mode::Check) {
+        Log::warning(Log::Graphics, "The check mode is only available in a debug build.\n");
+      }
+#endif
+
+      if (!settings.contextReady || !GLAD_GL_KHR_debug) {
+        if (settings.contextReady && settings.mode == GraphicsDebug::Mode::Callback) {
+          Log::info(Log::Graphics, "GL_KHR_debug is not available, the OpenGL errors are not reported. Use the check mode instead.\n");
+        }
+
+        return;
+      }
+
+      if (settings.mode != GraphicsDebug::Mode::Callback) {
+        glCheck(glDisable(GL_DEBUG_OUTPUT_KHR));
+        glCheck(glDebugMessageCallbackKHR(nullptr, nullptr));
+        return;
+      }
+
+      glCheck(glEnable(GL_DEBUG_OUTPUT_KHR));
+
+      if (settings.synchronous) {
+        glCheck(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR));
+      } else {
+        glCheck(glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR));
+      }
+
+      glCheck(glDebugMessageCallbackKHR(debugCallback, nullptr));
+
+      // let the driver discard the messages below the minimum severity
+      static constexpr GLenum Severities[] = {
+        GL_DEBUG_SEVERITY_NOTIFICATION_KHR, GL_DEBUG_SEVERITY_LOW_KHR, GL_DEBUG_SEVERITY_MEDIUM_KHR, GL_DEBUG_SEVERITY_HIGH_KHR
+      };
+
+      for (GLenum severity : Severities) {
+        GLboolean enabled = getLevel(severity) >= settings.severity ? GL_TRUE : GL_FALSE;
+        glCheck(glDebugMessageControlKHR(GL_DONT_CARE, GL_DONT_CARE, severity, 0, nullptr, enabled));
+      }
+    }
+
   }
 }
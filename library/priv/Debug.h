@@ -23,19 +23,44 @@
 
 #include <iostream>
 
+#include <gf/GraphicsDebug.h>
+#include <gf/Log.h>
 #include <gf/Matrix.h>
 #include <gf/Rect.h>
 #include <gf/Vector.h>
 
 #ifdef GF_DEBUG
-    #define glCheck(expr) do { expr; gf::priv::glCheckError(__FILE__, __LINE__, #expr); } while (false)
+    #define glCheck(expr) do { gf::priv::glCheckCall(__FILE__, __LINE__, #expr); expr; gf::priv::glCheckError(__FILE__, __LINE__, #expr); } while (false)
 #else
     #define glCheck(expr) (expr)
 #endif
 
 namespace gf {
   namespace priv {
+    // remember the location of the call for the messages of the debug callback
+    void glCheckCall(const char* file, unsigned int line, const char* expr);
+    // check the error of the call, only in the check mode
     void glCheckError(const char* file, unsigned int line, const char* expr);
+
+    struct DebugSettings {
+#ifdef GF_DEBUG
+      GraphicsDebug::Mode mode = GraphicsDebug::Mode::Callback;
+#else
+      // a debug context is slower on many drivers
+      GraphicsDebug::Mode mode = GraphicsDebug::Mode::None;
+#endif
+      Log::Level severity = Log::Warn;
+      bool synchronous = false;
+      bool contextReady = false;
+    };
+
+    DebugSettings& getDebugSettings();
+
+    // must be called when a context has been created and made current
+    void initializeDebug();
+
+    // send the settings to the current context, if any
+    void applyDebugSettings();
   }
 
   template<typename T, std::size_t N>
@@ -0,0 +1,68 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include "Instancing.h"
+
+#include <cassert>
+
+#include "Debug.h"
+
+namespace gf {
+  namespace priv {
+
+    bool hasInstancedArrays() {
+      return GLAD_GL_EXT_instanced_arrays || GLAD_GL_ANGLE_instanced_arrays || (GLAD_GL_NV_instanced_arrays && GLAD_GL_NV_draw_instanced);
+    }
+
+    void vertexAttribDivisor(GLuint index, GLuint divisor) {
+      if (GLAD_GL_EXT_instanced_arrays) {
+        glCheck(glVertexAttribDivisorEXT(index, divisor));
+      } else if (GLAD_GL_ANGLE_instanced_arrays) {
+        glCheck(glVertexAttribDivisorANGLE(index, divisor));
+      } else {
+        assert(GLAD_GL_NV_instanced_arrays);
+        glCheck(glVertexAttribDivisorNV(index, divisor));
+      }
+    }
+
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei primcount) {
+      if (GLAD_GL_EXT_instanced_arrays) {
+        glCheck(glDrawArraysInstancedEXT(mode, first, count, primcount));
+      } else if (GLAD_GL_ANGLE_instanced_arrays) {
+        glCheck(glDrawArraysInstancedANGLE(mode, first, count, primcount));
+      } else {
+        assert(GLAD_GL_NV_draw_instanced);
+        glCheck(glDrawArraysInstancedNV(mode, first, count, primcount));
+      }
+    }
+
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount) {
+      if (GLAD_GL_EXT_instanced_arrays) {
+        glCheck(glDrawElementsInstancedEXT(mode, count, type, indices, primcount));
+      } else if (GLAD_GL_ANGLE_instanced_arrays) {
+        glCheck(glDrawElementsInstancedANGLE(mode, count, type, indices, primcount));
+      } else {
+        assert(GLAD_GL_NV_draw_instanced);
+        glCheck(glDrawElementsInstancedNV(mode, count, type, indices, primcount));
+      }
+    }
+
+  }
+}
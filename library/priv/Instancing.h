@@ -0,0 +1,48 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_INSTANCING_H
+#define GF_INSTANCING_H
+
+#include <glad/glad.h>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Instanced drawing is not part of OpenGL ES 2.0, it comes from one of
+     * the extensions: GL_EXT_instanced_arrays, GL_ANGLE_instanced_arrays or
+     * GL_NV_instanced_arrays with GL_NV_draw_instanced. These functions
+     * dispatch to the first extension available in the context.
+     *
+     * The other functions must only be called if hasInstancedArrays()
+     * returns true.
+     */
+
+    bool hasInstancedArrays();
+
+    void vertexAttribDivisor(GLuint index, GLuint divisor);
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount);
+
+  }
+}
+
+#endif // GF_INSTANCING_H
@@ -0,0 +1,199 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include "Primitives.h"
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+
+namespace gf {
+  namespace priv {
+
+    bool isListPrimitive(PrimitiveType type) {
+      switch (type) {
+        case PrimitiveType::Points:
+        case PrimitiveType::Lines:
+        case PrimitiveType::Triangles:
+        case PrimitiveType::Quads:
+          return true;
+        case PrimitiveType::LineStrip:
+        case PrimitiveType::LineLoop:
+        case PrimitiveType::TriangleStrip:
+        case PrimitiveType::TriangleFan:
+          return false;
+      }
+
+      assert(false);
+      return false;
+    }
+
+    template<typename T>
+    static uint32_t getVertex(const T *indices, std::size_t i, uint32_t base) {
+      return base + (indices != nullptr ? static_cast<uint32_t>(indices[i]) : static_cast<uint32_t>(i));
+    }
+
+    static void appendTriangle(uint32_t i0, uint32_t i1, uint32_t i2, std::vector<uint32_t>& result) {
+      if (i0 == i1 || i1 == i2 || i2 == i0) {
+        return;
+      }
+
+      result.push_back(i0);
+      result.push_back(i1);
+      result.push_back(i2);
+    }
+
+    template<typename T>
+    static PrimitiveType appendListIndicesImpl(PrimitiveType type, const T *indices, std::size_t count, uint32_t base, std::vector<uint32_t>& result) {
+      switch (type) {
+        case PrimitiveType::Points:
+          for (std::size_t i = 0; i < count; ++i) {
+            result.push_back(getVertex(indices, i, base));
+          }
+          return PrimitiveType::Points;
+
+        case PrimitiveType::Lines:
+          for (std::size_t i = 0; i + 1 < count; i += 2) {
+            result.push_back(getVertex(indices, i, base));
+            result.push_back(getVertex(indices, i + 1, base));
+          }
+          return PrimitiveType::Lines;
+
+        case PrimitiveType::LineStrip:
+        case PrimitiveType::LineLoop:
+          for (std::size_t i = 0; i + 1 < count; ++i) {
+            result.push_back(getVertex(indices, i, base));
+            result.push_back(getVertex(indices, i + 1, base));
+          }
+
+          if (type == PrimitiveType::LineLoop && count >= 2) {
+            result.push_back(getVertex(indices, count - 1, base));
+            result.push_back(getVertex(indices, 0, base));
+          }
+          return PrimitiveType::Lines;
+
+        case PrimitiveType::Triangles:
+          for (std::size_t i = 0; i + 2 < count; i += 3) {
+            appendTriangle(getVertex(indices, i, base), getVertex(indices, i + 1, base), getVertex(indices, i + 2, base), result);
+          }
+          return PrimitiveType::Triangles;
+
+        case PrimitiveType::TriangleStrip:
+          for (std::size_t i = 0; i + 2 < count; ++i) {
+            // the odd triangles are reversed to keep the same orientation
+            if (i % 2 == 0) {
+              appendTriangle(getVertex(indices, i, base), getVertex(indices, i + 1, base), getVertex(indices, i + 2, base), result);
+            } else {
+              appendTriangle(getVertex(indices, i + 1, base), getVertex(indices, i, base), getVertex(indices, i + 2, base), result);
+            }
+          }
+          return PrimitiveType::Triangles;
+
+        case PrimitiveType::TriangleFan:
+          for (std::size_t i = 1; i + 1 < count; ++i) {
+            appendTriangle(getVertex(indices, 0, base), getVertex(indices, i, base), getVertex(indices, i + 1, base), result);
+          }
+          return PrimitiveType::Triangles;
+
+        case PrimitiveType::Quads:
+          for (std::size_t i = 0; i + 3 < count; i += 4) {
+            // same triangles as gf::RenderTarget
+            appendTriangle(getVertex(indices, i, base), getVertex(indices, i + 1, base), getVertex(indices, i + 2, base), result);
+            appendTriangle(getVertex(indices, i + 2, base), getVertex(indices, i + 1, base), getVertex(indices, i + 3, base), result);
+          }
+          return PrimitiveType::Triangles;
+      }
+
+      assert(false);
+      return type;
+    }
+
+    PrimitiveType appendListIndices(PrimitiveType type, const uint16_t *indices, std::size_t count, uint32_t base, std::vector<uint32_t>& result) {
+      return appendListIndicesImpl(type, indices, count, base, result);
+    }
+
+    PrimitiveType appendListIndices(PrimitiveType type, const uint32_t *indices, std::size_t count, uint32_t base, std::vector<uint32_t>& result) {
+      return appendListIndicesImpl(type, indices, count, base, result);
+    }
+
+    static std::size_t getPrimitiveSize(PrimitiveType type) {
+      switch (type) {
+        case PrimitiveType::Points:
+          return 1;
+        case PrimitiveType::Lines:
+          return 2;
+        case PrimitiveType::Triangles:
+          return 3;
+        default:
+          break;
+      }
+
+      assert(false);
+      return 1;
+    }
+
+    static constexpr std::size_t MaxChunkVertexCount = 65536;
+    static constexpr uint32_t Unmapped = std::numeric_limits<uint32_t>::max();
+
+    void splitIndices(PrimitiveType type, const uint32_t *indices, std::size_t count, const IndexChunkCallback& callback) {
+      std::size_t size = getPrimitiveSize(type);
+      count -= count % size;
+
+      if (indices == nullptr || count == 0) {
+        return;
+      }
+
+      uint32_t maxIndex = *std::max_element(indices, indices + count);
+      std::vector<uint32_t> remap(std::size_t(maxIndex) + 1, Unmapped);
+
+      std::vector<uint32_t> vertices;
+      std::vector<uint16_t> local;
+
+      for (std::size_t i = 0; i < count; i += size) {
+        if (vertices.size() + size > MaxChunkVertexCount) {
+          callback(vertices.data(), vertices.size(), local.data(), local.size());
+
+          for (uint32_t vertex : vertices) {
+            remap[vertex] = Unmapped;
+          }
+
+          vertices.clear();
+          local.clear();
+        }
+
+        for (std::size_t k = 0; k < size; ++k) {
+          uint32_t vertex = indices[i + k];
+
+          if (remap[vertex] == Unmapped) {
+            remap[vertex] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(vertex);
+          }
+
+          local.push_back(static_cast<uint16_t>(remap[vertex]));
+        }
+      }
+
+      if (!local.empty()) {
+        callback(vertices.data(), vertices.size(), local.data(), local.size());
+      }
+    }
+
+  }
+}
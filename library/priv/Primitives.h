@@ -0,0 +1,65 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_PRIMITIVES_H
+#define GF_PRIMITIVES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <gf/PrimitiveType.h>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Conversion of primitives to lists
+     *
+     * Lists of primitives (points, lines, triangles, quads) can be
+     * concatenated and split freely, unlike strips, fans and loops. These
+     * functions convert any primitive to the equivalent list, so that
+     * several draw calls can be merged in a single call, or so that a draw
+     * call can be split in smaller calls.
+     */
+
+    bool isListPrimitive(PrimitiveType type);
+
+    // Append the indices of the list equivalent to the primitives. The
+    // vertices are `base + indices[i]`, or `base + i` if `indices` is null.
+    // Quads are four vertices each, as in non-indexed draws. Degenerate
+    // triangles are removed. The type of the list is returned (points, lines
+    // or triangles).
+    PrimitiveType appendListIndices(PrimitiveType type, const uint16_t *indices, std::size_t count, uint32_t base, std::vector<uint32_t>& result);
+    PrimitiveType appendListIndices(PrimitiveType type, const uint32_t *indices, std::size_t count, uint32_t base, std::vector<uint32_t>& result);
+
+    // Split a list (points, lines or triangles) in chunks that use at most
+    // 65536 vertices, so that each chunk can be drawn with 16-bit indices.
+    // For each chunk, the callback receives the original index of the
+    // vertices of the chunk, and the indices in these vertices.
+    using IndexChunkCallback = std::function<void(const uint32_t *vertices, std::size_t vertexCount, const uint16_t *indices, std::size_t indexCount)>;
+
+    void splitIndices(PrimitiveType type, const uint32_t *indices, std::size_t count, const IndexChunkCallback& callback);
+
+  }
+}
+
+#endif // GF_PRIMITIVES_H
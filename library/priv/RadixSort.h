@@ -0,0 +1,87 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_RADIX_SORT_H
+#define GF_RADIX_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Stable LSD radix sort on the 64-bit keys, one byte per pass. The
+     * histograms of all the bytes are computed in a single pass and the bytes
+     * that are the same for every key are skipped, so that a sort on a 32-bit
+     * key only costs four passes. The items must have a `uint64_t key`.
+     */
+    template<typename Item>
+    void radixSort(std::vector<Item>& items, std::vector<Item>& buffer) {
+      static constexpr std::size_t Passes = sizeof(uint64_t);
+      static constexpr std::size_t Buckets = 256;
+
+      std::size_t count = items.size();
+
+      if (count < 2) {
+        return;
+      }
+
+      std::size_t histograms[Passes][Buckets];
+      std::memset(histograms, 0, sizeof histograms);
+
+      for (auto& item : items) {
+        for (std::size_t pass = 0; pass < Passes; ++pass) {
+          histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+        }
+      }
+
+      buffer.resize(count);
+
+      for (std::size_t pass = 0; pass < Passes; ++pass) {
+        std::size_t *histogram = histograms[pass];
+        unsigned shift = pass * 8;
+
+        if (histogram[(items.front().key >> shift) & 0xFF] == count) {
+          continue; // every key has the same byte
+        }
+
+        std::size_t offset = 0;
+
+        for (std::size_t i = 0; i < Buckets; ++i) {
+          std::size_t bucketCount = histogram[i];
+          histogram[i] = offset;
+          offset += bucketCount;
+        }
+
+        for (auto& item : items) {
+          buffer[histogram[(item.key >> shift) & 0xFF]++] = item;
+        }
+
+        items.swap(buffer);
+      }
+    }
+
+  }
+}
+
+#endif // GF_RADIX_SORT_H
@@ -0,0 +1,62 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_RENDER_COUNTERS_H
+#define GF_RENDER_COUNTERS_H
+
+#include <cstddef>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Counters of the rendering commands sent to OpenGL
+     *
+     * Like the state cache, the counters are global to the context: the
+     * textures, the shaders and the buffers are not owned by a render
+     * target. They are updated where the actual OpenGL call is made.
+     */
+    struct RenderCounters {
+      std::size_t drawCalls = 0;
+      std::size_t vertices = 0;
+      std::size_t textureBinds = 0;
+      std::size_t shaderSwitches = 0;
+      std::size_t bufferUploads = 0;
+      std::size_t bufferUploadSize = 0;
+      std::size_t textureUploads = 0;
+      std::size_t framebufferSwitches = 0;
+
+      void countDraw(std::size_t count) {
+        ++drawCalls;
+        vertices += count;
+      }
+
+      void countBufferUpload(std::size_t size) {
+        ++bufferUploads;
+        bufferUploadSize += size;
+      }
+    };
+
+    RenderCounters& getRenderCounters();
+
+  }
+}
+
+#endif // GF_RENDER_COUNTERS_H
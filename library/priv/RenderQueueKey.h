@@ -0,0 +1,93 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_RENDER_QUEUE_KEY_H
+#define GF_RENDER_QUEUE_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include <gf/PrimitiveType.h>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * Layout of the sort key of a command of gf::RenderQueue, from the most
+     * significant bit:
+     *
+     * - layer (16 bits)
+     * - view (8 bits)
+     * - ordered (1 bit)
+     * - for commands sorted by state: shader (8 bits), texture (12 bits),
+     *   mode (8 bits) and primitive (2 bits)
+     * - for ordered commands: submission order (24 bits)
+     *
+     * The commands sorted by state come before the ordered commands of the
+     * same layer and view. When a table is full, the queue is flushed before
+     * the new command.
+     */
+
+    constexpr std::size_t RenderQueueMaxViewCount = 1 << 8;
+    constexpr std::size_t RenderQueueMaxShaderCount = 1 << 8;
+    constexpr std::size_t RenderQueueMaxTextureCount = 1 << 12;
+    constexpr std::size_t RenderQueueMaxModeCount = 1 << 8;
+    constexpr std::size_t RenderQueueMaxCommandCount = 1 << 24;
+
+    inline uint64_t getRenderQueueLayerKey(int layer, std::size_t view) {
+      uint64_t key = static_cast<uint64_t>(static_cast<uint16_t>(std::min(std::max(layer, -32768), 32767) + 32768)) << 48;
+      key |= static_cast<uint64_t>(view) << 40;
+      return key;
+    }
+
+    inline uint64_t getRenderQueueOrderedKey(int layer, std::size_t view, std::size_t order) {
+      uint64_t key = getRenderQueueLayerKey(layer, view);
+      key |= UINT64_C(1) << 39;
+      key |= static_cast<uint64_t>(order) << 15;
+      return key;
+    }
+
+    inline uint64_t getRenderQueuePrimitiveKey(PrimitiveType type) {
+      switch (type) {
+        case PrimitiveType::Points:
+          return 0;
+        case PrimitiveType::Lines:
+          return 1;
+        default:
+          break;
+      }
+
+      return 2;
+    }
+
+    inline uint64_t getRenderQueueStateKey(int layer, std::size_t view, std::size_t shader, std::size_t texture, std::size_t mode, PrimitiveType type) {
+      uint64_t key = getRenderQueueLayerKey(layer, view);
+      key |= static_cast<uint64_t>(shader) << 31;
+      key |= static_cast<uint64_t>(texture) << 19;
+      key |= static_cast<uint64_t>(mode) << 11;
+      key |= getRenderQueuePrimitiveKey(type) << 9;
+      return key;
+    }
+
+  }
+}
+
+#endif // GF_RENDER_QUEUE_KEY_H
@@ -0,0 +1,279 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include "StateCache.h"
+
+#include <algorithm>
+
+#include "Debug.h"
+#include "Instancing.h"
+#include "RenderCounters.h"
+
+namespace gf {
+  namespace priv {
+
+    constexpr std::size_t StateCache::MaxTextureUnits;
+    constexpr std::size_t StateCache::MaxAttributes;
+
+    StateCache::StateCache()
+    : m_maxAttributes(0)
+    , m_changed(0)
+    , m_skipped(0)
+    {
+      invalidate();
+    }
+
+    void StateCache::invalidate() {
+      m_blendKnown = false;
+      std::fill(std::begin(m_blend), std::end(m_blend), 0);
+      m_viewportKnown = false;
+      std::fill(std::begin(m_viewport), std::end(m_viewport), 0);
+      m_programKnown = false;
+      m_program = 0;
+      m_activeUnitKnown = false;
+      m_activeUnit = 0;
+      m_texturesKnown = 0;
+      std::fill(std::begin(m_textures), std::end(m_textures), 0);
+      m_arrayBufferKnown = false;
+      m_arrayBuffer = 0;
+      m_elementArrayBufferKnown = false;
+      m_elementArrayBuffer = 0;
+      m_attributesKnown = false;
+      m_attributes = 0;
+      m_divisorsKnown = false;
+      m_divisors = 0;
+    }
+
+    void StateCache::setBlend(GLenum colorEquation, GLenum alphaEquation, GLenum colorSrcFactor, GLenum colorDstFactor, GLenum alphaSrcFactor, GLenum alphaDstFactor) {
+      GLenum blend[6] = { colorEquation, alphaEquation, colorSrcFactor, colorDstFactor, alphaSrcFactor, alphaDstFactor };
+
+      if (skip(m_blendKnown && std::equal(std::begin(blend), std::end(blend), std::begin(m_blend)))) {
+        return;
+      }
+
+      glCheck(glBlendEquationSeparate(colorEquation, alphaEquation));
+      glCheck(glBlendFuncSeparate(colorSrcFactor, colorDstFactor, alphaSrcFactor, alphaDstFactor));
+
+      std::copy(std::begin(blend), std::end(blend), std::begin(m_blend));
+      m_blendKnown = true;
+    }
+
+    void StateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+      GLint viewport[4] = { x, y, width, height };
+
+      if (skip(m_viewportKnown && std::equal(std::begin(viewport), std::end(viewport), std::begin(m_viewport)))) {
+        return;
+      }
+
+      glCheck(glViewport(x, y, width, height));
+
+      std::copy(std::begin(viewport), std::end(viewport), std::begin(m_viewport));
+      m_viewportKnown = true;
+    }
+
+    void StateCache::useProgram(GLuint program) {
+      if (skip(m_programKnown && m_program == program)) {
+        return;
+      }
+
+      glCheck(glUseProgram(program));
+      ++getRenderCounters().shaderSwitches;
+
+      m_program = program;
+      m_programKnown = true;
+    }
+
+    void StateCache::activeTexture(unsigned unit) {
+      if (skip(m_activeUnitKnown && m_activeUnit == unit)) {
+        return;
+      }
+
+      glCheck(glActiveTexture(GL_TEXTURE0 + unit));
+
+      m_activeUnit = unit;
+      m_activeUnitKnown = true;
+    }
+
+    void StateCache::bindTexture(GLuint name) {
+      if (!m_activeUnitKnown || m_activeUnit >= MaxTextureUnits) {
+        glCheck(glBindTexture(GL_TEXTURE_2D, name));
+        ++getRenderCounters().textureBinds;
+        ++m_changed;
+
+        if (!m_activeUnitKnown) {
+          // we do not know which unit has changed
+          m_texturesKnown = 0;
+        }
+
+        return;
+      }
+
+      uint32_t bit = UINT32_C(1) << m_activeUnit;
+
+      if (skip((m_texturesKnown & bit) != 0 && m_textures[m_activeUnit] == name)) {
+        return;
+      }
+
+      glCheck(glBindTexture(GL_TEXTURE_2D, name));
+      ++getRenderCounters().textureBinds;
+
+      m_textures[m_activeUnit] = name;
+      m_texturesKnown |= bit;
+    }
+
+    void StateCache::bindTexture(unsigned unit, GLuint name) {
+      if (unit >= MaxTextureUnits) {
+        activeTexture(unit);
+        bindTexture(name);
+        return;
+      }
+
+      uint32_t bit = UINT32_C(1) << unit;
+
+      if (skip((m_texturesKnown & bit) != 0 && m_textures[unit] == name)) {
+        return;
+      }
+
+      // not through bindTexture(name), the change is already counted
+      activeTexture(unit);
+      glCheck(glBindTexture(GL_TEXTURE_2D, name));
+      ++getRenderCounters().textureBinds;
+
+      m_textures[unit] = name;
+      m_texturesKnown |= bit;
+    }
+
+    void StateCache::bindArrayBuffer(GLuint name) {
+      if (skip(m_arrayBufferKnown && m_arrayBuffer == name)) {
+        return;
+      }
+
+      glCheck(glBindBuffer(GL_ARRAY_BUFFER, name));
+
+      m_arrayBuffer = name;
+      m_arrayBufferKnown = true;
+    }
+
+    void StateCache::bindElementArrayBuffer(GLuint name) {
+      if (skip(m_elementArrayBufferKnown && m_elementArrayBuffer == name)) {
+        return;
+      }
+
+      glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, name));
+
+      m_elementArrayBuffer = name;
+      m_elementArrayBufferKnown = true;
+    }
+
+    void StateCache::setEnabledAttributes(uint32_t mask) {
+      queryMaxAttributes();
+
+      uint32_t changes = m_attributesKnown ? (m_attributes ^ mask) : ~UINT32_C(0);
+
+      for (GLuint index = 0; index < m_maxAttributes; ++index) {
+        uint32_t bit = UINT32_C(1) << index;
+
+        if ((changes & bit) == 0) {
+          if ((mask & bit) != 0) {
+            ++m_skipped;
+          }
+
+          continue;
+        }
+
+        if ((mask & bit) != 0) {
+          glCheck(glEnableVertexAttribArray(index));
+        } else {
+          glCheck(glDisableVertexAttribArray(index));
+        }
+
+        ++m_changed;
+      }
+
+      m_attributes = mask;
+      m_attributesKnown = true;
+    }
+
+    void StateCache::setAttributeDivisors(uint32_t mask) {
+      queryMaxAttributes();
+
+      uint32_t changes = m_divisorsKnown ? (m_divisors ^ mask) : ~UINT32_C(0);
+
+      for (GLuint index = 0; index < m_maxAttributes; ++index) {
+        uint32_t bit = UINT32_C(1) << index;
+
+        if ((changes & bit) == 0) {
+          if ((mask & bit) != 0) {
+            ++m_skipped;
+          }
+
+          continue;
+        }
+
+        vertexAttribDivisor(index, (mask & bit) != 0 ? 1 : 0);
+        ++m_changed;
+      }
+
+      m_divisors = mask;
+      m_divisorsKnown = true;
+    }
+
+    void StateCache::queryMaxAttributes() {
+      if (m_maxAttributes == 0) {
+        GLint maxAttributes = 0;
+        glCheck(glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributes));
+        m_maxAttributes = std::min(static_cast<std::size_t>(maxAttributes), MaxAttributes);
+      }
+    }
+
+    void StateCache::forgetTexture(GLuint name) {
+      // deleting a texture unbinds it from all the units
+      for (std::size_t unit = 0; unit < MaxTextureUnits; ++unit) {
+        if (m_textures[unit] == name) {
+          m_textures[unit] = 0;
+        }
+      }
+    }
+
+    void StateCache::forgetBuffer(GLuint name) {
+      // deleting a buffer unbinds it
+      if (m_arrayBuffer == name) {
+        m_arrayBuffer = 0;
+      }
+
+      if (m_elementArrayBuffer == name) {
+        m_elementArrayBuffer = 0;
+      }
+    }
+
+    void StateCache::forgetProgram(GLuint program) {
+      // the program stays in use until another program is used
+      if (m_program == program) {
+        m_programKnown = false;
+      }
+    }
+
+    StateCache& getStateCache() {
+      static StateCache cache;
+      return cache;
+    }
+
+  }
+}
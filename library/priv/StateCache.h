@@ -0,0 +1,140 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_STATE_CACHE_H
+#define GF_STATE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * A cache of the OpenGL state of the context
+     *
+     * The OpenGL state is global to the context, so the cache is shared by
+     * all the render targets and all the resources (textures, buffers,
+     * shaders). Every function that changes a part of the state tracked here
+     * must go through the cache, otherwise the cache must be invalidated.
+     *
+     * When a value is unknown (at the beginning or after an invalidation),
+     * the next change is always sent to OpenGL.
+     */
+    class StateCache {
+    public:
+      static constexpr std::size_t MaxTextureUnits = 32;
+      static constexpr std::size_t MaxAttributes = 32;
+
+      StateCache();
+
+      void invalidate();
+
+      void setBlend(GLenum colorEquation, GLenum alphaEquation, GLenum colorSrcFactor, GLenum colorDstFactor, GLenum alphaSrcFactor, GLenum alphaDstFactor);
+      void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+      void useProgram(GLuint program);
+      GLuint getProgram() const {
+        return m_program;
+      }
+
+      void activeTexture(unsigned unit);
+      void bindTexture(GLuint name); // on the active unit
+      void bindTexture(unsigned unit, GLuint name);
+
+      void bindArrayBuffer(GLuint name);
+      void bindElementArrayBuffer(GLuint name);
+
+      // enable exactly the attributes in the mask, and disable the others
+      void setEnabledAttributes(uint32_t mask);
+
+      // set a divisor of 1 to the attributes in the mask, and 0 to the others
+      // (only with instanced arrays, see Instancing.h)
+      void setAttributeDivisors(uint32_t mask);
+
+      // must be called before the deletion of an object
+      void forgetTexture(GLuint name);
+      void forgetBuffer(GLuint name);
+      void forgetProgram(GLuint program);
+
+      std::size_t getChangedCount() const {
+        return m_changed;
+      }
+
+      std::size_t getSkippedCount() const {
+        return m_skipped;
+      }
+
+      void resetCounters() {
+        m_changed = m_skipped = 0;
+      }
+
+    private:
+      void queryMaxAttributes();
+
+      bool skip(bool redundant) {
+        if (redundant) {
+          ++m_skipped;
+        } else {
+          ++m_changed;
+        }
+
+        return redundant;
+      }
+
+    private:
+      bool m_blendKnown;
+      GLenum m_blend[6];
+
+      bool m_viewportKnown;
+      GLint m_viewport[4];
+
+      bool m_programKnown;
+      GLuint m_program;
+
+      bool m_activeUnitKnown;
+      unsigned m_activeUnit;
+
+      uint32_t m_texturesKnown;
+      GLuint m_textures[MaxTextureUnits];
+
+      bool m_arrayBufferKnown;
+      GLuint m_arrayBuffer;
+      bool m_elementArrayBufferKnown;
+      GLuint m_elementArrayBuffer;
+
+      std::size_t m_maxAttributes;
+      bool m_attributesKnown;
+      uint32_t m_attributes;
+      bool m_divisorsKnown;
+      uint32_t m_divisors;
+
+      std::size_t m_changed;
+      std::size_t m_skipped;
+    };
+
+    StateCache& getStateCache();
+
+  }
+}
+
+#endif // GF_STATE_CACHE_H
@@ -0,0 +1,148 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace gf {
+  namespace priv {
+
+    ThreadPool::ThreadPool()
+    : m_generation(0)
+    , m_busy(0)
+    , m_stop(false)
+    , m_task(nullptr)
+    , m_count(0)
+    , m_grain(1)
+    , m_next(0)
+    {
+
+    }
+
+    ThreadPool::~ThreadPool() {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+
+      m_wakeup.notify_all();
+
+      for (auto& thread : m_threads) {
+        thread.join();
+      }
+    }
+
+    std::size_t ThreadPool::getThreadCount() const {
+      // hardware_concurrency() may return 0 if the value is not computable
+      return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const Task& task) {
+      if (count == 0) {
+        return;
+      }
+
+      grain = std::max(grain, std::size_t(1));
+
+      if (count <= grain || getThreadCount() == 1) {
+        task(0, count);
+        return;
+      }
+
+      std::unique_lock<std::mutex> callLock(m_callMutex);
+
+      if (m_threads.empty()) {
+        start();
+      }
+
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_grain = grain;
+        m_next = 0;
+        m_busy = m_threads.size();
+        ++m_generation;
+      }
+
+      m_wakeup.notify_all();
+
+      work();
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_finished.wait(lock, [this]() { return m_busy == 0; });
+      m_task = nullptr;
+    }
+
+    void ThreadPool::start() {
+      std::size_t count = getThreadCount() - 1;
+
+      for (std::size_t i = 0; i < count; ++i) {
+        m_threads.emplace_back(&ThreadPool::run, this);
+      }
+    }
+
+    void ThreadPool::run() {
+      unsigned generation = 0;
+
+      for (;;) {
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_wakeup.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+
+          if (m_stop) {
+            return;
+          }
+
+          generation = m_generation;
+        }
+
+        work();
+
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          --m_busy;
+        }
+
+        m_finished.notify_one();
+      }
+    }
+
+    void ThreadPool::work() {
+      for (;;) {
+        std::size_t begin = m_next.fetch_add(m_grain);
+
+        if (begin >= m_count) {
+          return;
+        }
+
+        std::size_t end = std::min(begin + m_grain, m_count);
+        (*m_task)(begin, end);
+      }
+    }
+
+    ThreadPool& getThreadPool() {
+      static ThreadPool pool;
+      return pool;
+    }
+
+  }
+}
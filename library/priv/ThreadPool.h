@@ -0,0 +1,86 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#ifndef GF_THREAD_POOL_H
+#define GF_THREAD_POOL_H
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gf {
+  namespace priv {
+
+    /*
+     * A pool of worker threads for data-parallel loops
+     *
+     * parallelFor() splits a range in chunks that are processed by the
+     * workers and by the calling thread. It returns when all the chunks are
+     * done. The workers are started at the first call and sleep between the
+     * calls.
+     */
+    class ThreadPool {
+    public:
+      typedef std::function<void(std::size_t, std::size_t)> Task;
+
+      ThreadPool();
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      // number of threads that work on a loop, including the calling thread
+      std::size_t getThreadCount() const;
+
+      // call task(begin, end) on chunks of at most grain elements of [0, count)
+      void parallelFor(std::size_t count, std::size_t grain, const Task& task);
+
+    private:
+      void start();
+      void run();
+      void work();
+
+    private:
+      std::mutex m_callMutex;
+      std::vector<std::thread> m_threads;
+
+      std::mutex m_mutex;
+      std::condition_variable m_wakeup;
+      std::condition_variable m_finished;
+      unsigned m_generation;
+      std::size_t m_busy;
+      bool m_stop;
+
+      const Task *m_task;
+      std::size_t m_count;
+      std::size_t m_grain;
+      std::atomic<std::size_t> m_next;
+    };
+
+    ThreadPool& getThreadPool();
+
+  }
+}
+
+#endif // GF_THREAD_POOL_H
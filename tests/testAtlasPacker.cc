@@ -0,0 +1,66 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/AtlasPacker.h>
+
+#include "gtest/gtest.h"
+
+TEST(RectanglePackerTest, Insert) {
+  gf::RectanglePacker packer({ 64, 64 });
+
+  gf::RectU r1;
+  EXPECT_TRUE(packer.insert({ 32, 32 }, r1));
+  EXPECT_EQ(32u, r1.width);
+  EXPECT_EQ(32u, r1.height);
+
+  gf::RectU r2;
+  EXPECT_TRUE(packer.insert({ 32, 64 }, r2));
+  EXPECT_FALSE(r1.intersects(r2));
+
+  gf::RectU r3;
+  EXPECT_TRUE(packer.insert({ 32, 32 }, r3));
+  EXPECT_FALSE(r1.intersects(r3));
+  EXPECT_FALSE(r2.intersects(r3));
+
+  EXPECT_FLOAT_EQ(1.0f, packer.getOccupancy());
+
+  gf::RectU r4;
+  EXPECT_FALSE(packer.insert({ 1, 1 }, r4));
+}
+
+TEST(RectanglePackerTest, TooBig) {
+  gf::RectanglePacker packer({ 64, 64 });
+
+  gf::RectU rect;
+  EXPECT_FALSE(packer.insert({ 65, 1 }, rect));
+  EXPECT_FALSE(packer.insert({ 0, 10 }, rect));
+}
+
+TEST(RectanglePackerTest, Rotation) {
+  gf::RectanglePacker packer({ 64, 32 }, true);
+
+  gf::RectU rect;
+  EXPECT_TRUE(packer.insert({ 32, 64 }, rect));
+  EXPECT_EQ(64u, rect.width);
+  EXPECT_EQ(32u, rect.height);
+
+  gf::RectanglePacker fixed({ 64, 32 });
+  EXPECT_FALSE(fixed.insert({ 32, 64 }, rect));
+}
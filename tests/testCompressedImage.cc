@@ -0,0 +1,343 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include "priv/CompressedImage.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+  using Pixel = std::array<int, 4>;
+
+  std::vector<uint8_t> decodeBlock(GLenum format, std::vector<uint8_t> data) {
+    gf::priv::CompressedLevel level = { gf::Vector2u(4, 4), data.data(), data.size() };
+    std::vector<uint8_t> pixels;
+    EXPECT_TRUE(gf::priv::decodeCompressedLevel(format, level, pixels));
+    EXPECT_EQ(64u, pixels.size());
+    return pixels;
+  }
+
+  Pixel getPixel(const std::vector<uint8_t>& pixels, unsigned x, unsigned y) {
+    const uint8_t *pixel = &pixels[(y * 4 + x) * 4];
+    return {{ pixel[0], pixel[1], pixel[2], pixel[3] }};
+  }
+
+  void write32(std::vector<uint8_t>& data, std::size_t offset, uint32_t value) {
+    for (std::size_t i = 0; i < 4; ++i) {
+      data[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  std::vector<uint8_t> createKtx(uint32_t format, uint32_t width, uint32_t height, uint32_t levels) {
+    std::vector<uint8_t> data = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    data.resize(64, 0);
+    write32(data, 12, 0x04030201); // endianness
+    write32(data, 16, 0); // glType
+    write32(data, 20, 1); // glTypeSize
+    write32(data, 24, 0); // glFormat
+    write32(data, 28, format); // glInternalFormat
+    write32(data, 32, 0x1907); // glBaseInternalFormat
+    write32(data, 36, width);
+    write32(data, 40, height);
+    write32(data, 44, 0); // depth
+    write32(data, 48, 0); // array elements
+    write32(data, 52, 1); // faces
+    write32(data, 56, levels);
+    write32(data, 60, 0); // key/value data
+    return data;
+  }
+
+  std::vector<uint8_t> createDds(uint32_t fourCC, uint32_t width, uint32_t height, uint32_t levels) {
+    std::vector<uint8_t> data = { 'D', 'D', 'S', ' ' };
+    data.resize(4 + 124, 0);
+    write32(data, 4, 124); // size
+    write32(data, 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000); // flags
+    write32(data, 12, height);
+    write32(data, 16, width);
+    write32(data, 28, levels);
+    write32(data, 76, 32); // pixel format size
+    write32(data, 80, 0x4); // pixel format flags: FourCC
+    write32(data, 84, fourCC);
+    write32(data, 108, 0x1000); // caps: texture
+    return data;
+  }
+
+  constexpr uint32_t makeFourCC(char c0, char c1, char c2, char c3) {
+    return uint32_t(c0) | (uint32_t(c1) << 8) | (uint32_t(c2) << 16) | (uint32_t(c3) << 24);
+  }
+
+}
+
+/*
+ * S3TC
+ */
+
+TEST(CompressedImageTest, Dxt1FourColors) {
+  // red and blue, indices 0, 1, 2, 3 for the first row
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaS3tcDxt1, { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00 });
+
+  EXPECT_EQ(Pixel({{ 255, 0, 0, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 0, 0, 255, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 170, 0, 85, 255 }}), getPixel(pixels, 2, 0));
+  EXPECT_EQ(Pixel({{ 85, 0, 170, 255 }}), getPixel(pixels, 3, 0));
+  EXPECT_EQ(Pixel({{ 255, 0, 0, 255 }}), getPixel(pixels, 3, 3));
+}
+
+TEST(CompressedImageTest, Dxt1ThreeColors) {
+  // blue and red, the first color is smaller so the last index is transparent
+  std::vector<uint8_t> block = { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0x00, 0x00, 0x00 };
+
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaS3tcDxt1, block);
+  EXPECT_EQ(Pixel({{ 0, 0, 255, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 255, 0, 0, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 127, 0, 127, 255 }}), getPixel(pixels, 2, 0));
+  EXPECT_EQ(Pixel({{ 0, 0, 0, 0 }}), getPixel(pixels, 3, 0));
+
+  // without alpha, the last index is opaque black
+  pixels = decodeBlock(gf::priv::CompressedRgbS3tcDxt1, block);
+  EXPECT_EQ(Pixel({{ 0, 0, 0, 255 }}), getPixel(pixels, 3, 0));
+}
+
+TEST(CompressedImageTest, Dxt3) {
+  // explicit alpha 0, 15, 8, 5 for the first row, then four colors even if
+  // the first color is smaller
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaS3tcDxt3, {
+    0xF0, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1F, 0x00, 0x00, 0xF8, 0xE4, 0x00, 0x00, 0x00
+  });
+
+  EXPECT_EQ(Pixel({{ 0, 0, 255, 0 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 255, 0, 0, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 85, 0, 170, 136 }}), getPixel(pixels, 2, 0));
+  EXPECT_EQ(Pixel({{ 170, 0, 85, 85 }}), getPixel(pixels, 3, 0));
+}
+
+TEST(CompressedImageTest, Dxt5EightAlphas) {
+  // alpha 255 and 0, indices 0, 1, 2, 7 for the first row
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaS3tcDxt5, {
+    0xFF, 0x00, 0x88, 0x0E, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  });
+
+  EXPECT_EQ(Pixel({{ 255, 255, 255, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 255, 255, 255, 0 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 255, 255, 255, 218 }}), getPixel(pixels, 2, 0));
+  EXPECT_EQ(Pixel({{ 255, 255, 255, 36 }}), getPixel(pixels, 3, 0));
+}
+
+TEST(CompressedImageTest, Dxt5SixAlphas) {
+  // alpha 0 and 255, indices 2, 6, 7, 5 for the first row
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaS3tcDxt5, {
+    0x00, 0xFF, 0xF2, 0x0B, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  });
+
+  EXPECT_EQ(51, getPixel(pixels, 0, 0)[3]);
+  EXPECT_EQ(0, getPixel(pixels, 1, 0)[3]);
+  EXPECT_EQ(255, getPixel(pixels, 2, 0)[3]);
+  EXPECT_EQ(204, getPixel(pixels, 3, 0)[3]);
+}
+
+/*
+ * ETC1 and ETC2
+ */
+
+TEST(CompressedImageTest, Etc1Individual) {
+  // bases (255, 0, 136) and (0, 255, 136), tables 0 and 7, side by side
+  auto pixels = decodeBlock(gf::priv::CompressedRgbEtc1, { 0xF0, 0x0F, 0x88, 0x1C, 0x80, 0x30, 0x80, 0x22 });
+
+  EXPECT_EQ(Pixel({{ 255, 2, 138, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 255, 8, 144, 255 }}), getPixel(pixels, 0, 1));
+  EXPECT_EQ(Pixel({{ 253, 0, 134, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 247, 0, 128, 255 }}), getPixel(pixels, 1, 1));
+  EXPECT_EQ(Pixel({{ 47, 255, 183, 255 }}), getPixel(pixels, 2, 0));
+  EXPECT_EQ(Pixel({{ 47, 255, 183, 255 }}), getPixel(pixels, 3, 0));
+  EXPECT_EQ(Pixel({{ 0, 72, 0, 255 }}), getPixel(pixels, 3, 3));
+}
+
+TEST(CompressedImageTest, Etc1Differential) {
+  // bases (132, 66, 0) and (140, 57, 0), tables 1 and 2, one above the other
+  auto pixels = decodeBlock(gf::priv::CompressedRgbEtc1, { 0x81, 0x47, 0x00, 0x2B, 0x00, 0x00, 0x00, 0x00 });
+
+  EXPECT_EQ(Pixel({{ 137, 71, 5, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 137, 71, 5, 255 }}), getPixel(pixels, 3, 1));
+  EXPECT_EQ(Pixel({{ 149, 66, 9, 255 }}), getPixel(pixels, 0, 2));
+  EXPECT_EQ(Pixel({{ 149, 66, 9, 255 }}), getPixel(pixels, 3, 3));
+}
+
+TEST(CompressedImageTest, Etc2T) {
+  // colors (221, 34, 51) and (136, 68, 0), distance 16
+  auto pixels = decodeBlock(gf::priv::CompressedRgbEtc2, { 0xF9, 0x23, 0x84, 0x07, 0x00, 0x30, 0x00, 0x22 });
+
+  EXPECT_EQ(Pixel({{ 221, 34, 51, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 152, 84, 16, 255 }}), getPixel(pixels, 0, 1));
+  EXPECT_EQ(Pixel({{ 136, 68, 0, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 120, 52, 0, 255 }}), getPixel(pixels, 1, 1));
+}
+
+TEST(CompressedImageTest, Etc2H) {
+  // colors (68, 119, 85) and (34, 34, 34), distance 32
+  auto pixels = decodeBlock(gf::priv::CompressedRgbEtc2, { 0x23, 0xF2, 0x91, 0x16, 0x00, 0x30, 0x00, 0x22 });
+
+  EXPECT_EQ(Pixel({{ 100, 151, 117, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 36, 87, 53, 255 }}), getPixel(pixels, 0, 1));
+  EXPECT_EQ(Pixel({{ 66, 66, 66, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 255 }}), getPixel(pixels, 1, 1));
+}
+
+TEST(CompressedImageTest, Etc2Planar) {
+  // origin (0, 0, 113), horizontal (255, 0, 0), vertical (0, 255, 0)
+  auto pixels = decodeBlock(gf::priv::CompressedRgbEtc2, { 0x00, 0x00, 0xFA, 0x7F, 0x00, 0x00, 0x1F, 0xC0 });
+
+  EXPECT_EQ(Pixel({{ 0, 0, 113, 255 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 64, 0, 85, 255 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 191, 0, 28, 255 }}), getPixel(pixels, 3, 0));
+  EXPECT_EQ(Pixel({{ 0, 191, 28, 255 }}), getPixel(pixels, 0, 3));
+  EXPECT_EQ(Pixel({{ 64, 128, 28, 255 }}), getPixel(pixels, 1, 2));
+  EXPECT_EQ(Pixel({{ 191, 191, 0, 255 }}), getPixel(pixels, 3, 3));
+}
+
+TEST(CompressedImageTest, Etc2Eac) {
+  // alpha base 250, multiplier 15, table 13, then a gray ETC1 block
+  auto pixels = decodeBlock(gf::priv::CompressedRgbaEtc2, {
+    0xFA, 0xFD, 0x7E, 0x41, 0x24, 0x92, 0x49, 0x21,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  });
+
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 100 }}), getPixel(pixels, 0, 0));
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 255 }}), getPixel(pixels, 0, 1));
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 235 }}), getPixel(pixels, 1, 0));
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 250 }}), getPixel(pixels, 2, 2));
+  EXPECT_EQ(Pixel({{ 2, 2, 2, 220 }}), getPixel(pixels, 3, 3));
+}
+
+TEST(CompressedImageTest, PartialBlock) {
+  std::vector<uint8_t> data = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00 };
+  gf::priv::CompressedLevel level = { gf::Vector2u(2, 1), data.data(), data.size() };
+
+  std::vector<uint8_t> pixels;
+  ASSERT_TRUE(gf::priv::decodeCompressedLevel(gf::priv::CompressedRgbaS3tcDxt1, level, pixels));
+  ASSERT_EQ(8u, pixels.size());
+  EXPECT_EQ(255, pixels[0]);
+  EXPECT_EQ(255, pixels[6]);
+}
+
+TEST(CompressedImageTest, TruncatedLevel) {
+  std::vector<uint8_t> data(8, 0);
+  gf::priv::CompressedLevel level = { gf::Vector2u(8, 4), data.data(), data.size() };
+
+  std::vector<uint8_t> pixels;
+  EXPECT_FALSE(gf::priv::decodeCompressedLevel(gf::priv::CompressedRgbEtc1, level, pixels));
+}
+
+/*
+ * Containers
+ */
+
+TEST(CompressedImageTest, Ktx) {
+  std::vector<uint8_t> data = createKtx(gf::priv::CompressedRgbEtc1, 4, 4, 2);
+
+  // each level has its size, then one block
+  for (uint8_t level = 0; level < 2; ++level) {
+    data.insert(data.end(), { 8, 0, 0, 0 });
+    data.insert(data.end(), { level, 1, 2, 3, 4, 5, 6, 7 });
+  }
+
+  EXPECT_TRUE(gf::priv::isCompressedContainer(data.data(), data.size()));
+
+  gf::priv::CompressedImage image;
+  ASSERT_TRUE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+  EXPECT_EQ(gf::priv::CompressedRgbEtc1, image.format);
+  ASSERT_EQ(2u, image.levels.size());
+
+  EXPECT_EQ(gf::Vector2u(4, 4), image.levels[0].size);
+  EXPECT_EQ(data.data() + 68, image.levels[0].data);
+  EXPECT_EQ(8u, image.levels[0].length);
+
+  EXPECT_EQ(gf::Vector2u(2, 2), image.levels[1].size);
+  EXPECT_EQ(data.data() + 80, image.levels[1].data);
+  EXPECT_EQ(8u, image.levels[1].length);
+}
+
+TEST(CompressedImageTest, KtxTruncated) {
+  std::vector<uint8_t> data = createKtx(gf::priv::CompressedRgbEtc1, 4, 4, 1);
+  data.insert(data.end(), { 8, 0, 0, 0, 0, 0, 0, 0 });
+
+  gf::priv::CompressedImage image;
+  EXPECT_FALSE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+}
+
+TEST(CompressedImageTest, KtxTooManyLevels) {
+  // a 4x4 texture has 3 levels, the following levels would be zero-sized
+  std::vector<uint8_t> data = createKtx(gf::priv::CompressedRgbEtc1, 4, 4, 40);
+
+  for (std::size_t level = 0; level < 40; ++level) {
+    data.insert(data.end(), { 0, 0, 0, 0 });
+  }
+
+  gf::priv::CompressedImage image;
+  EXPECT_FALSE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+}
+
+TEST(CompressedImageTest, Dds) {
+  std::vector<uint8_t> data = createDds(makeFourCC('D', 'X', 'T', '1'), 4, 4, 1);
+  data.insert(data.end(), { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00 });
+
+  EXPECT_TRUE(gf::priv::isCompressedContainer(data.data(), data.size()));
+
+  gf::priv::CompressedImage image;
+  ASSERT_TRUE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+  EXPECT_EQ(gf::priv::CompressedRgbaS3tcDxt1, image.format);
+  ASSERT_EQ(1u, image.levels.size());
+  EXPECT_EQ(gf::Vector2u(4, 4), image.levels[0].size);
+  EXPECT_EQ(8u, image.levels[0].length);
+
+  std::vector<uint8_t> pixels;
+  ASSERT_TRUE(gf::priv::decodeCompressedLevel(image.format, image.levels[0], pixels));
+  EXPECT_EQ(Pixel({{ 170, 0, 85, 255 }}), getPixel(pixels, 2, 0));
+}
+
+TEST(CompressedImageTest, DdsExtended) {
+  std::vector<uint8_t> data = createDds(makeFourCC('D', 'X', '1', '0'), 4, 4, 1);
+  std::vector<uint8_t> extended(20, 0);
+  write32(extended, 0, 77); // DXGI_FORMAT_BC3_UNORM
+  write32(extended, 4, 3); // texture 2D
+  write32(extended, 12, 1); // array size
+  data.insert(data.end(), extended.begin(), extended.end());
+  data.resize(data.size() + 16, 0);
+
+  gf::priv::CompressedImage image;
+  ASSERT_TRUE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+  EXPECT_EQ(gf::priv::CompressedRgbaS3tcDxt5, image.format);
+  ASSERT_EQ(1u, image.levels.size());
+  EXPECT_EQ(16u, image.levels[0].length);
+}
+
+TEST(CompressedImageTest, Unknown) {
+  std::vector<uint8_t> data(128, 0);
+  EXPECT_FALSE(gf::priv::isCompressedContainer(data.data(), data.size()));
+
+  gf::priv::CompressedImage image;
+  EXPECT_FALSE(gf::priv::loadCompressedImage(data.data(), data.size(), image));
+}
@@ -0,0 +1,156 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include "priv/RadixSort.h"
+#include "priv/RenderQueueKey.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+  struct Item {
+    uint64_t key;
+    uint32_t index;
+  };
+
+  std::vector<uint32_t> sortIndices(std::vector<Item> items) {
+    std::vector<Item> buffer;
+    gf::priv::radixSort(items, buffer);
+
+    std::vector<uint32_t> indices;
+
+    for (auto& item : items) {
+      indices.push_back(item.index);
+    }
+
+    return indices;
+  }
+
+}
+
+TEST(RenderQueueKeyTest, Layer) {
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(-1, 0, 0), gf::priv::getRenderQueueOrderedKey(0, 0, 0));
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 0, 0), gf::priv::getRenderQueueOrderedKey(1, 0, 0));
+
+  // the layer comes before the view and the order
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 255, 1000), gf::priv::getRenderQueueOrderedKey(1, 0, 0));
+
+  // out of range layers are clamped
+  EXPECT_EQ(gf::priv::getRenderQueueOrderedKey(-32768, 0, 0), gf::priv::getRenderQueueOrderedKey(-40000, 0, 0));
+  EXPECT_EQ(gf::priv::getRenderQueueOrderedKey(32767, 0, 0), gf::priv::getRenderQueueOrderedKey(40000, 0, 0));
+}
+
+TEST(RenderQueueKeyTest, View) {
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 0, 1000), gf::priv::getRenderQueueOrderedKey(0, 1, 0));
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, 255, 4095, 255, gf::PrimitiveType::Triangles), gf::priv::getRenderQueueStateKey(0, 1, 0, 0, 0, gf::PrimitiveType::Points));
+}
+
+TEST(RenderQueueKeyTest, Order) {
+  std::size_t maxOrder = gf::priv::RenderQueueMaxCommandCount - 1;
+
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 0, 0), gf::priv::getRenderQueueOrderedKey(0, 0, 1));
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 0, maxOrder - 1), gf::priv::getRenderQueueOrderedKey(0, 0, maxOrder));
+
+  // the order does not overflow in the view
+  EXPECT_LT(gf::priv::getRenderQueueOrderedKey(0, 0, maxOrder), gf::priv::getRenderQueueOrderedKey(0, 1, 0));
+}
+
+TEST(RenderQueueKeyTest, State) {
+  std::size_t maxShader = gf::priv::RenderQueueMaxShaderCount - 1;
+  std::size_t maxTexture = gf::priv::RenderQueueMaxTextureCount - 1;
+  std::size_t maxMode = gf::priv::RenderQueueMaxModeCount - 1;
+
+  // the commands sorted by state come before the ordered commands
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, maxShader, maxTexture, maxMode, gf::PrimitiveType::Triangles), gf::priv::getRenderQueueOrderedKey(0, 0, 0));
+
+  // shader, then texture, then mode, then primitive
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, 0, maxTexture, 0, gf::PrimitiveType::Points), gf::priv::getRenderQueueStateKey(0, 0, 1, 0, 0, gf::PrimitiveType::Points));
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, 0, 0, maxMode, gf::PrimitiveType::Points), gf::priv::getRenderQueueStateKey(0, 0, 0, 1, 0, gf::PrimitiveType::Points));
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Triangles), gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 1, gf::PrimitiveType::Points));
+  EXPECT_LT(gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Points), gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Lines));
+  EXPECT_EQ(gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::TriangleStrip), gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Triangles));
+}
+
+TEST(RadixSortTest, Sort) {
+  std::vector<Item> items;
+  uint64_t key = UINT64_C(0x9E3779B97F4A7C15);
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    key = key * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+    items.push_back({ key, i });
+  }
+
+  std::vector<Item> expected = items;
+  std::stable_sort(expected.begin(), expected.end(), [](const Item& lhs, const Item& rhs) {
+    return lhs.key < rhs.key;
+  });
+
+  std::vector<Item> buffer;
+  gf::priv::radixSort(items, buffer);
+
+  ASSERT_EQ(expected.size(), items.size());
+
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(expected[i].key, items[i].key);
+    EXPECT_EQ(expected[i].index, items[i].index);
+  }
+}
+
+TEST(RadixSortTest, Stable) {
+  std::vector<Item> items = {
+    { 2, 0 }, { 1, 1 }, { 2, 2 }, { 1, 3 }, { 2, 4 }, { 1, 5 }
+  };
+
+  std::vector<uint32_t> expected = { 1, 3, 5, 0, 2, 4 };
+  EXPECT_EQ(expected, sortIndices(items));
+}
+
+TEST(RadixSortTest, OrderedCommands) {
+  // commands submitted in layers 1, 0, 1, 0, 1
+  std::vector<int> layers = { 1, 0, 1, 0, 1 };
+  std::vector<Item> items;
+
+  for (uint32_t i = 0; i < layers.size(); ++i) {
+    items.push_back({ gf::priv::getRenderQueueOrderedKey(layers[i], 0, i), i });
+  }
+
+  // each layer keeps the order of submission
+  std::vector<uint32_t> expected = { 1, 3, 0, 2, 4 };
+  EXPECT_EQ(expected, sortIndices(items));
+}
+
+TEST(RadixSortTest, StateSortedCommands) {
+  // opaque commands with textures 1, 0, 1, 0 and a translucent command
+  std::vector<Item> items = {
+    { gf::priv::getRenderQueueStateKey(0, 0, 0, 1, 0, gf::PrimitiveType::Triangles), 0 },
+    { gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Triangles), 1 },
+    { gf::priv::getRenderQueueOrderedKey(0, 0, 2), 2 },
+    { gf::priv::getRenderQueueStateKey(0, 0, 0, 1, 0, gf::PrimitiveType::Triangles), 3 },
+    { gf::priv::getRenderQueueStateKey(0, 0, 0, 0, 0, gf::PrimitiveType::Triangles), 4 },
+  };
+
+  // the commands with the same texture are adjacent, so they are merged
+  std::vector<uint32_t> expected = { 1, 4, 0, 3, 2 };
+  EXPECT_EQ(expected, sortIndices(items));
+}
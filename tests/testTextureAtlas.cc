@@ -0,0 +1,47 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/TextureAtlas.h>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(TextureAtlasTest, BinaryFile) {
+  gf::Path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gf-%%%%-%%%%.atlas");
+
+  gf::TextureAtlas saved;
+  saved.setTexturePath("bricks.png");
+  saved.addSubTexture("brick1", gf::RectU(0, 0, 32, 16));
+  saved.addSubTexture("brick2", gf::RectU(32, 0, 64, 16));
+  ASSERT_TRUE(saved.saveToBinaryFile(filename));
+
+  gf::TextureAtlas loaded;
+  ASSERT_TRUE(loaded.loadFromFile(filename));
+  boost::filesystem::remove(filename);
+
+  EXPECT_EQ(gf::Path("bricks.png"), loaded.getTexturePath());
+
+  gf::RectU rect = loaded.getSubTexture("brick2");
+  EXPECT_EQ(32u, rect.left);
+  EXPECT_EQ(0u, rect.top);
+  EXPECT_EQ(64u, rect.width);
+  EXPECT_EQ(16u, rect.height);
+}
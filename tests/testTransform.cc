@@ -0,0 +1,140 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <gf/Transform.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static gf::Matrix3f getTestMatrix() {
+  gf::Matrix3f mat = gf::identity<gf::Matrix3f>();
+  gf::translate(mat, { 12.5f, -3.25f });
+  gf::rotate(mat, 0.3f);
+  gf::scale(mat, { 1.5f, 0.75f });
+  return mat;
+}
+
+static std::vector<gf::Vector2f> getTestPoints(std::size_t count) {
+  std::vector<gf::Vector2f> points;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    points.push_back({ static_cast<float>(i) * 1.5f - 7.0f, static_cast<float>(i * i % 13) * -0.5f + 2.0f });
+  }
+
+  return points;
+}
+
+TEST(TransformTest, TransformArray) {
+  gf::Matrix3f mat = getTestMatrix();
+
+  for (std::size_t count = 0; count < 12; ++count) {
+    auto points = getTestPoints(count);
+    std::vector<gf::Vector2f> result(count);
+    gf::transform(mat, points.data(), result.data(), count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      gf::Vector2f expected = gf::transform(mat, points[i]);
+      EXPECT_EQ(expected.x, result[i].x);
+      EXPECT_EQ(expected.y, result[i].y);
+    }
+  }
+}
+
+TEST(TransformTest, TransformArrayInPlace) {
+  gf::Matrix3f mat = getTestMatrix();
+
+  auto points = getTestPoints(11);
+  auto result = points;
+  gf::transform(mat, result.data(), result.data(), result.size());
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    gf::Vector2f expected = gf::transform(mat, points[i]);
+    EXPECT_EQ(expected.x, result[i].x);
+    EXPECT_EQ(expected.y, result[i].y);
+  }
+}
+
+TEST(TransformTest, TransformStrided) {
+  struct Item {
+    gf::Vector2f point;
+    float padding[3];
+  };
+
+  gf::Matrix3f mat = getTestMatrix();
+
+  auto points = getTestPoints(7);
+  std::vector<Item> items(points.size());
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    items[i].point = points[i];
+  }
+
+  std::vector<gf::Vector2f> result(points.size());
+  gf::transform(mat, &items[0].point, sizeof(Item), result.data(), sizeof(gf::Vector2f), items.size());
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    gf::Vector2f expected = gf::transform(mat, points[i]);
+    EXPECT_EQ(expected.x, result[i].x);
+    EXPECT_EQ(expected.y, result[i].y);
+  }
+}
+
+TEST(TransformTest, ComputeBounds) {
+  EXPECT_TRUE(gf::computeBounds(nullptr, 0).isEmpty());
+
+  for (std::size_t count = 1; count < 12; ++count) {
+    auto points = getTestPoints(count);
+    gf::RectF bounds = gf::computeBounds(points.data(), count);
+
+    gf::Vector2f min = points[0];
+    gf::Vector2f max = points[0];
+
+    for (auto& point : points) {
+      min = gf::min(min, point);
+      max = gf::max(max, point);
+    }
+
+    EXPECT_EQ(min.x, bounds.left);
+    EXPECT_EQ(min.y, bounds.top);
+    EXPECT_EQ(max.x - min.x, bounds.width);
+    EXPECT_EQ(max.y - min.y, bounds.height);
+  }
+}
+
+TEST(TransformTest, ExpandQuads) {
+  gf::Matrix3f transforms[3] = { getTestMatrix(), gf::identity<gf::Matrix3f>(), gf::translation({ 1.0f, 2.0f }) };
+  gf::Vector2f sizes[3] = { { 16.0f, 32.0f }, { 1.0f, 1.0f }, { 0.5f, 4.0f } };
+  gf::Vector2f result[12];
+
+  gf::expandQuads(transforms, sizes, result, sizeof(gf::Vector2f), 3);
+
+  for (std::size_t i = 0; i < 3; ++i) {
+    gf::Vector2f corners[4] = {
+      { 0.0f, 0.0f }, { sizes[i].width, 0.0f }, { 0.0f, sizes[i].height }, sizes[i]
+    };
+
+    for (std::size_t j = 0; j < 4; ++j) {
+      gf::Vector2f expected = gf::transform(transforms[i], corners[j]);
+      EXPECT_EQ(expected.x, result[i * 4 + j].x);
+      EXPECT_EQ(expected.y, result[i * 4 + j].y);
+    }
+  }
+}
@@ -0,0 +1,208 @@
+/*
+ * Gamedev Framework (gf)
+ * Copyright (C) 2016 Julien Bernard
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <gf/AtlasPacker.h>
+#include <gf/Filesystem.h>
+#include <gf/Image.h>
+#include <gf/TextureAtlas.h>
+
+/*
+ * gf_atlas: pack a directory of PNG images in a texture atlas
+ *
+ * The tool writes <output>.png with the packed images and <output>.atlas
+ * with the binary description that gf::TextureAtlas can load. The name of
+ * each sub-texture is the filename of its image without the extension.
+ */
+
+namespace {
+
+  struct Sprite {
+    std::string name;
+    gf::Image image;
+    gf::RectU rect;
+  };
+
+  void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [options] <directory> <output>\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  -s, --size <size>        Maximum size of the atlas (default: 2048)\n";
+    std::cerr << "  -p, --padding <padding>  Space between the images (default: 1)\n";
+  }
+
+  // try the power of two sizes, from the smallest that holds the biggest image, until every image fits
+  bool pack(std::vector<Sprite>& sprites, unsigned minSize, unsigned maxSize, unsigned padding, gf::Vector2u& atlasSize) {
+    unsigned size = 1;
+
+    while (size < minSize) {
+      size *= 2;
+    }
+
+    for (; size <= maxSize; size *= 2) {
+      gf::RectanglePacker packer({ size + padding, size + padding });
+      bool packed = true;
+
+      for (auto& sprite : sprites) {
+        gf::Vector2u imageSize = sprite.image.getSize();
+
+        if (!packer.insert({ imageSize.width + padding, imageSize.height + padding }, sprite.rect)) {
+          packed = false;
+          break;
+        }
+
+        sprite.rect.size = imageSize;
+      }
+
+      if (packed) {
+        atlasSize = { size, size };
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+}
+
+int main(int argc, char *argv[]) {
+  unsigned maxSize = 2048;
+  unsigned padding = 1;
+  std::vector<std::string> arguments;
+
+  for (int i = 1; i < argc; ++i) {
+    if ((std::strcmp(argv[i], "-s") == 0 || std::strcmp(argv[i], "--size") == 0) && i + 1 < argc) {
+      maxSize = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if ((std::strcmp(argv[i], "-p") == 0 || std::strcmp(argv[i], "--padding") == 0) && i + 1 < argc) {
+      padding = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      arguments.push_back(argv[i]);
+    }
+  }
+
+  if (arguments.size() != 2) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  gf::Path directory(arguments[0]);
+  gf::Path output(arguments[1]);
+
+  if (!boost::filesystem::is_directory(directory)) {
+    std::cerr << "Not a directory: " << directory.string() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  std::vector<gf::Path> files;
+
+  for (auto& entry : boost::filesystem::directory_iterator(directory)) {
+    gf::Path path = entry.path();
+
+    if (boost::filesystem::is_regular_file(path) && path.extension() == ".png") {
+      files.push_back(path);
+    }
+  }
+
+  // the order of the directory is not specified, sort for reproducible atlases
+  std::sort(files.begin(), files.end());
+
+  std::vector<Sprite> sprites;
+
+  for (auto& file : files) {
+    Sprite sprite;
+    sprite.name = file.stem().string();
+
+    if (!sprite.image.loadFromFile(file)) {
+      return EXIT_FAILURE;
+    }
+
+    sprites.push_back(std::move(sprite));
+  }
+
+  if (sprites.empty()) {
+    std::cerr << "No PNG image in: " << directory.string() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  // the biggest images first, they are the hardest to place
+  std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& lhs, const Sprite& rhs) {
+    gf::Vector2u lhsSize = lhs.image.getSize();
+    gf::Vector2u rhsSize = rhs.image.getSize();
+    return std::max(lhsSize.width, lhsSize.height) > std::max(rhsSize.width, rhsSize.height);
+  });
+
+  gf::Vector2u biggestSize = sprites.front().image.getSize();
+  unsigned minSize = std::max(biggestSize.width, biggestSize.height);
+
+  if (minSize > maxSize) {
+    std::cerr << "The image '" << sprites.front().name << "' (" << biggestSize.width << 'x' << biggestSize.height << ") is bigger than the maximum size " << maxSize << '\n';
+    return EXIT_FAILURE;
+  }
+
+  gf::Vector2u atlasSize;
+
+  if (!pack(sprites, minSize, maxSize, padding, atlasSize)) {
+    std::cerr << "The images do not fit in an atlas of size " << maxSize << '\n';
+    return EXIT_FAILURE;
+  }
+
+  gf::Image image;
+  image.create(atlasSize, gf::Color4u{ 0x00, 0x00, 0x00, 0x00 });
+
+  gf::Path imagePath = output;
+  imagePath += ".png";
+
+  gf::TextureAtlas atlas;
+  atlas.setTexturePath(imagePath.filename());
+
+  for (auto& sprite : sprites) {
+    for (unsigned y = 0; y < sprite.rect.height; ++y) {
+      for (unsigned x = 0; x < sprite.rect.width; ++x) {
+        image.setPixel({ sprite.rect.left + x, sprite.rect.top + y }, sprite.image.getPixel({ x, y }));
+      }
+    }
+
+    atlas.addSubTexture(sprite.name, sprite.rect);
+  }
+
+  if (!image.saveToFile(imagePath)) {
+    return EXIT_FAILURE;
+  }
+
+  gf::Path atlasPath = output;
+  atlasPath += ".atlas";
+
+  if (!atlas.saveToBinaryFile(atlasPath)) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Packed " << sprites.size() << " images in " << imagePath.string() << " (" << atlasSize.width << 'x' << atlasSize.height << ")\n";
+  return EXIT_SUCCESS;
+}